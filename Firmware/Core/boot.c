@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file    boot.c
+ * @brief   Keeps track of the boot milestones, and reports them to the host
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot.h"
+#include "main.h"
+#include "tusb.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+// Time at which each milestone was reached, in ms since reset; zero if not reached yet
+volatile uint32_t bootMilestones[BOOT_MILESTONE_COUNT] = {0};
+
+// Set when a milestone has been reached since the previous report
+volatile bool isBootMilestoneReportPending = false;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Records the current time for the given milestone; only the first
+ *         occurrence of each milestone is recorded
+ * @param  milestone Milestone that was reached
+ */
+void RecordBootMilestone(BootMilestone_t milestone)
+{
+    if (milestone >= BOOT_MILESTONE_COUNT || bootMilestones[milestone] != 0)
+    {
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+
+    // Zero is reserved for milestones that have not been reached
+    bootMilestones[milestone] = now != 0 ? now : 1;
+    isBootMilestoneReportPending = true;
+}
+
+/**
+ * @brief  Checks whether the given milestone has been reached
+ * @param  milestone Milestone to check
+ *
+ * @retval True if the milestone has been reached; false otherwise
+ */
+bool HasBootMilestone(BootMilestone_t milestone)
+{
+    return milestone < BOOT_MILESTONE_COUNT && bootMilestones[milestone] != 0;
+}
+
+/**
+ * @brief  Enqueues the boot milestones as a new report if a milestone has been
+ *         reached since the previous report; reports are held back until the
+ *         host has configured the device so none of them are lost
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a report was enqueued; false otherwise
+ */
+bool ReportBootMilestones(RadioDevice_t *device)
+{
+    if (!isBootMilestoneReportPending || !tud_mounted())
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_BOOT_MILESTONES;
+
+    BootMilestonesReport_t *milestones = &report.bytes.bootMilestones;
+
+    milestones->enumerated = bootMilestones[BOOT_MILESTONE_ENUMERATED];
+    milestones->oscillatorReady = bootMilestones[BOOT_MILESTONE_OSCILLATOR_READY];
+    milestones->radioReady = bootMilestones[BOOT_MILESTONE_RADIO_READY];
+    milestones->firstAudio = bootMilestones[BOOT_MILESTONE_FIRST_AUDIO];
+
+    if (!EnqueueReport(device, &report))
+    {
+        // Try again on the next round
+        return false;
+    }
+
+    isBootMilestoneReportPending = false;
+
+    return true;
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/**
+ * @brief  Invoked by TinyUSB when the device has been configured by the host
+ */
+void tud_mount_cb(void)
+{
+    RecordBootMilestone(BOOT_MILESTONE_ENUMERATED);
+}
+
+/* Private functions ---------------------------------------------------------*/
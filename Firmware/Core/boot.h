@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file    boot.h
+ * @brief   Header for boot.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __BOOT_H__
+#define __BOOT_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum _BootMilestone_t : uint8_t
+{
+    /* The host has enumerated and configured the USB device */
+    BOOT_MILESTONE_ENUMERATED = 0x00,
+
+    /* The radio oscillator has had its maximum startup time to stabilize */
+    BOOT_MILESTONE_OSCILLATOR_READY = 0x01,
+
+    /* The radio has tuned to a station and enabled its digital audio output */
+    BOOT_MILESTONE_RADIO_READY = 0x02,
+
+    /* The first block of radio audio has been delivered to a streaming host */
+    BOOT_MILESTONE_FIRST_AUDIO = 0x03,
+
+    /* Number of milestones; not a milestone itself */
+    BOOT_MILESTONE_COUNT = 0x04,
+} BootMilestone_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+// The oscillator has a max startup time of one second
+// The radio chip also has a startup time but it is much faster than the
+// crystal
+#define RADIO_OSCILLATOR_STARTUP_TIME 1250
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern void RecordBootMilestone(BootMilestone_t milestone);
+extern bool HasBootMilestone(BootMilestone_t milestone);
+extern bool ReportBootMilestones(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __BOOT_H__ */
@@ -0,0 +1,238 @@
+/**
+ ******************************************************************************
+ * @file    fault.c
+ * @brief   Implements the fault capture and recovery; a fault is recorded into
+ *          RAM that survives the reset, the watchdog resets the device, and
+ *          the record is reported once the host has enumerated it again
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fault.h"
+#include "main.h"
+#include "tusb.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _FaultRecord_t
+{
+    /* Marks the record valid; the RAM holds garbage after power-on */
+    uint32_t signature;
+
+    /* The recorded fault; the source is cleared once the fault has been reported */
+    FaultReport_t report;
+} FaultRecord_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+#define FAULT_RECORD_SIGNATURE 0xFA017ECD
+
+// Offsets of the link register, program counter and program status register in the exception stack frame
+#define STACK_FRAME_LR 5
+#define STACK_FRAME_PC 6
+#define STACK_FRAME_XPSR 7
+
+// The watchdog counts the 40 kHz LSI divided by 32, so it expires after about a second
+#define WATCHDOG_PRESCALER 0x03
+#define WATCHDOG_RELOAD 1250
+
+// Keys written to the watchdog key register
+#define WATCHDOG_KEY_START 0xCCCC
+#define WATCHDOG_KEY_ACCESS 0x5555
+#define WATCHDOG_KEY_REFRESH 0xAAAA
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+// Kept in the .noinit section, which the startup code neither initializes nor zeroes
+__attribute__((section(".noinit"))) FaultRecord_t faultRecord;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Validates the fault record left behind by the previous run, and
+ *         records a watchdog reset that no fault explains; must be called
+ *         at startup, before the reset flags are needed by anything else
+ */
+void CheckResetCause(void)
+{
+    const uint32_t flags = RCC->CSR;
+
+    // Clear the reset flags, so the next reset is told apart from this one
+    RCC->CSR |= RCC_CSR_RMVF;
+
+    if ((flags & RCC_CSR_PORRSTF) || faultRecord.signature != FAULT_RECORD_SIGNATURE)
+    {
+        memset(&faultRecord, 0, sizeof(faultRecord));
+        faultRecord.signature = FAULT_RECORD_SIGNATURE;
+    }
+
+    // A fault starts the watchdog itself, so a watchdog reset without a recorded fault means the main loop got stuck
+    if ((flags & RCC_CSR_IWDGRSTF) && faultRecord.report.source == FAULT_SOURCE_NONE)
+    {
+        faultRecord.report = (FaultReport_t){
+            .source = FAULT_SOURCE_WATCHDOG,
+            .faultCount = faultRecord.report.faultCount + 1,
+            .subsystem = SUBSYSTEM_COUNT,
+        };
+    }
+}
+
+/**
+ * @brief  Starts the independent watchdog; once started it cannot be stopped,
+ *         and the main loop must refresh it at least once a second
+ */
+void StartWatchdog(void)
+{
+    // Stop the watchdog while the core is halted by a debugger
+    __HAL_RCC_DBGMCU_CLK_ENABLE();
+    __HAL_DBGMCU_FREEZE_IWDG();
+
+    // Starting the watchdog also starts the LSI it runs from
+    IWDG->KR = WATCHDOG_KEY_START;
+    IWDG->KR = WATCHDOG_KEY_ACCESS;
+    IWDG->PR = WATCHDOG_PRESCALER;
+    IWDG->RLR = WATCHDOG_RELOAD - 1;
+
+    while (IWDG->SR != 0)
+    {
+    }
+
+    IWDG->KR = WATCHDOG_KEY_REFRESH;
+}
+
+/**
+ * @brief  Refreshes the independent watchdog
+ */
+void RefreshWatchdog(void)
+{
+    IWDG->KR = WATCHDOG_KEY_REFRESH;
+}
+
+/**
+ * @brief  Records the fault, along with the command being processed at the
+ *         time, and waits for the watchdog to reset the device
+ * @param  source What brought the device down
+ * @param  programCounter Address of the faulting instruction
+ * @param  linkRegister Link register at the time of the fault
+ * @param  programStatus Program status register at the time of the fault
+ */
+void RecordFault(FaultSource_t source, uint32_t programCounter, uint32_t linkRegister, uint32_t programStatus)
+{
+    __disable_irq();
+
+    FaultReport_t *report = &faultRecord.report;
+
+    report->source = source;
+    report->programCounter = programCounter;
+    report->linkRegister = linkRegister;
+    report->programStatus = programStatus;
+    report->radioState = radioDevice.currentState;
+    report->commandOpCode = 0;
+    report->commandState = 0;
+    report->faultCount++;
+
+    // Only the supervisor names a subsystem, which RecordSubsystemFailure() sets before the call
+    if (source != FAULT_SOURCE_SUPERVISOR)
+    {
+        report->subsystem = SUBSYSTEM_COUNT;
+    }
+
+    // The queue may be what got corrupted, so its indices are checked before use
+    CommandQueue_t *queue = &radioDevice.commandQueue;
+
+    if (queue->count > 0 && queue->front < MAX_COMMAND_QUEUE_CAPACITY)
+    {
+        report->commandOpCode = queue->commands[queue->front].args.opCode;
+        report->commandState = queue->commands[queue->front].state;
+    }
+
+    faultRecord.signature = FAULT_RECORD_SIGNATURE;
+
+    // Start the watchdog in case the fault came before the main loop did, and let it expire
+    IWDG->KR = WATCHDOG_KEY_START;
+
+    while (1)
+    {
+    }
+}
+
+/**
+ * @brief  Records the subsystem the supervisor gave up on, and waits for the
+ *         watchdog to reset the device
+ * @param  subsystem Subsystem that stopped making progress
+ */
+void RecordSubsystemFailure(SupervisedSubsystem_t subsystem)
+{
+    faultRecord.report.subsystem = subsystem;
+
+    RecordFault(FAULT_SOURCE_SUPERVISOR, 0, 0, 0);
+}
+
+/**
+ * @brief  Records a hard fault from the stack frame pushed by the exception
+ * @param  stackFrame Pointer to the exception stack frame
+ */
+void CaptureHardFault(const uint32_t *stackFrame)
+{
+    RecordFault(FAULT_SOURCE_HARD_FAULT,
+                stackFrame[STACK_FRAME_PC],
+                stackFrame[STACK_FRAME_LR],
+                stackFrame[STACK_FRAME_XPSR]);
+}
+
+/**
+ * @brief  Records a non-maskable interrupt from the stack frame pushed by the exception
+ * @param  stackFrame Pointer to the exception stack frame
+ */
+void CaptureNonMaskableInterrupt(const uint32_t *stackFrame)
+{
+    RecordFault(FAULT_SOURCE_NMI,
+                stackFrame[STACK_FRAME_PC],
+                stackFrame[STACK_FRAME_LR],
+                stackFrame[STACK_FRAME_XPSR]);
+}
+
+/**
+ * @brief  Enqueues the fault recorded by the previous run as a new report,
+ *         once the host has enumerated the device
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a report was enqueued; false otherwise
+ */
+bool ReportFault(RadioDevice_t *device)
+{
+    if (faultRecord.report.source == FAULT_SOURCE_NONE || !tud_mounted())
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_FAULT;
+    report.bytes.fault = faultRecord.report;
+
+    if (!EnqueueReport(device, &report))
+    {
+        return false;
+    }
+
+    // Keep the count for the next fault
+    faultRecord.report.source = FAULT_SOURCE_NONE;
+
+    return true;
+}
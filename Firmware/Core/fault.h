@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ * @file    fault.h
+ * @brief   Header for fault.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __FAULT_H__
+#define __FAULT_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include "reports.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern void CheckResetCause(void);
+extern void StartWatchdog(void);
+extern void RefreshWatchdog(void);
+extern void RecordFault(FaultSource_t source, uint32_t programCounter, uint32_t linkRegister,
+                        uint32_t programStatus) __attribute__((noreturn));
+extern void RecordSubsystemFailure(SupervisedSubsystem_t subsystem) __attribute__((noreturn));
+extern void CaptureHardFault(const uint32_t *stackFrame) __attribute__((noreturn));
+extern void CaptureNonMaskableInterrupt(const uint32_t *stackFrame) __attribute__((noreturn));
+extern bool ReportFault(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FAULT_H__ */
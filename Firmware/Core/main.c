@@ -15,15 +15,26 @@
  */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "af.h"
+#include "antcap.h"
+#include "audio_monitor.h"
+#include "boot.h"
 #include "commands.h"
 #include "common.h"
 #include "device.h"
 #include "dma.h"
+#include "fault.h"
 #include "gpio.h"
 #include "i2c.h"
 #include "i2s.h"
+#include "memory.h"
+#include "presets.h"
 #include "properties.h"
 #include "rds.h"
+#include "scan.h"
+#include "settings.h"
+#include "supervisor.h"
+#include "telemetry.h"
 #include "tim.h"
 #include "tusb.h"
 
@@ -55,132 +66,103 @@ void SystemClock_Config(void);
  */
 int main(void)
 {
+    // Paint the free RAM before anything else runs, so the stack high-water mark can be measured
+    PaintStack();
+
     // Initialize HAL
     HAL_Init();
 
+    // Pick up the fault record left behind by the previous run, and tell why the device was reset
+    CheckResetCause();
+
     // Configure the system clock
     SystemClock_Config();
 
+    // Reset the device if the main loop stops running for about a second
+    StartWatchdog();
+
     // Initialize peripherals
     MX_GPIO_Init();
     MX_DMA_Init();
     MX_I2C1_Init();
     MX_I2S1_Init();
+    MX_TIM2_Init();
     MX_TIM16_Init();
     MX_TIM17_Init();
 
+    // Start the free-running microsecond counter
+    HAL_TIM_Base_Start(&htim2);
+
     // Initialize the RDS parser library
     RDSInit();
 
+    // USB needs only peripheral clock and interrupt priority; TinyUSB takes care of the rest
+    __HAL_RCC_USB_CLK_ENABLE();
+    HAL_NVIC_SetPriority(USB_IRQn, 0, 0);
+
+    // Initialize TinyUSB first so the host can enumerate the device while the
+    // radio is still starting up
+    tusb_rhport_init_t dev_init = {.role = TUSB_ROLE_DEVICE, .speed = TUSB_SPEED_FULL};
+
+    tusb_init(BOARD_DEVICE_RHPORT_NUM, &dev_init);
+
     // Bring Si4705 out of reset, and enable the oscillator
     HAL_GPIO_WritePin(RADIO_NRST_GPIO_Port, RADIO_NRST_Pin, GPIO_PIN_SET);
     HAL_GPIO_WritePin(RCLK_EN_GPIO_Port, RCLK_EN_Pin, GPIO_PIN_SET);
 
-    // The oscillator has a max startup time of one second
-    // The radio chip also has a startup time but it is much faster than the
-    // crystal
-    HAL_Delay(1250);
+    // Instead of waiting for the oscillator here, the commands below are only
+    // queued; the command processing holds them back until the deadline passes
+    radioDevice.oscillatorReadyTick = HAL_GetTick() + RADIO_OSCILLATOR_STARTUP_TIME;
 
-    // Start the timer that's used to report device status
+    // Start the timer that's used to report the audio and interrupt statistics
     HAL_TIM_Base_Start_IT(&htim17);
 
-    // Power up the radio
-    if (!PowerUp(&radioDevice,
-                 POWER_UP_ARGS_1_FUNCTION_FM | POWER_UP_ARGS_1_GPO2_OUTPUT_ENABLE |
-                     POWER_UP_ARGS_1_CTS_INTERRUPT_ENABLE,
-                 POWER_UP_ARGS_2_DIGITAL_OUTPUT_2))
-    {
-        Error_Handler();
-    }
-
-    // Enable other interrupt sources
-    if (!SetInterruptSources(&radioDevice,
-                             GPO_IEN_ARGS_CTSIEN | GPO_IEN_ARGS_STCIEN | GPO_IEN_ARGS_RDSIEN | GPO_IEN_ARGS_ERRIEN))
-    {
-        Error_Handler();
-    }
-
-    // Initialize volume from the radio state
-    if (!SetVolume(&radioDevice, radioDevice.currentVolume))
-    {
-        Error_Handler();
-    }
-
-    // Allow GPO output, and drive GPO1 and GPO3 low to reduce oscillation
-    if (!GPIOCtl(&radioDevice, GPIO_CTL_GPO1_OUTPUT_ENABLE | GPIO_CTL_GPO3_OUTPUT_ENABLE))
-    {
-        Error_Handler();
-    }
-
-    if (!GPIOSet(&radioDevice, GPIO_SET_GPO2_OUTPUT_HIGH))
-    {
-        Error_Handler();
-    }
-
-    // Set FM de-emphasis to match Europe
-    if (!SetFMDeemphasis(&radioDevice, FM_DEEMPHASIS_ARGS_50_MICROSECONDS))
+    // Power up the radio, and configure its interrupts, GPO pins and RDS
+    if (!StartRadio(&radioDevice))
     {
         Error_Handler();
     }
 
-    // Configure RDS to raise interrupt when buffers are full
-    if (!SetRDSInterruptSources(&radioDevice, FM_RDS_INT_SOURCE_ARGS_RDSRECV))
+    // Restore the volume, mute and de-emphasis, and tune to the last station;
+    // on the first boot this tunes to Kasari
+    if (!RestoreSettings(&radioDevice))
     {
         Error_Handler();
     }
 
-    // Configure the number of FIFO buffers in the RDS
-    if (!SetRDSFIFOCount(&radioDevice, 10))
+    // Start receiving I2S data through DMA; this provides DCLK and DFS for the radio chip
+    if (!StartAudioCapture())
     {
         Error_Handler();
     }
 
-    // Enable RDS processing
-    if (!SetRDSConfig(&radioDevice, FM_RDS_CONFIG_ARGS_RDS_ENABLE))
-    {
-        Error_Handler();
-    }
-
-    // Tune to Kasari
-    if (!TuneFreq(&radioDevice, FM_TUNE_FREQ_ARGS_NONE, 9410))
-    {
-        Error_Handler();
-    }
-
-    // Start receiving I2S data through DMA; this provides DCLK and DFS
-    // for the radio chip. When using circular mode, the size parameter
-    // must equal the number of elements in the receiving array
-    if (HAL_I2S_Receive_DMA(&hi2s1, &i2sBuffer[0], DMA_BUFFER_LENGTH) != HAL_OK)
-    {
-        Error_Handler();
-    }
-
-    // USB needs only peripheral clock and interrupt priority; TinyUSB takes care of the rest
-    __HAL_RCC_USB_CLK_ENABLE();
-    HAL_NVIC_SetPriority(USB_IRQn, 0, 0);
-
-    // Initialize TinyUSB
-    tusb_rhport_init_t dev_init = {.role = TUSB_ROLE_DEVICE, .speed = TUSB_SPEED_FULL};
-
-    tusb_init(BOARD_DEVICE_RHPORT_NUM, &dev_init);
-
     /* Infinite loop */
     while (1)
     {
-        tud_task();
-
-        if (!ProcessCommand(&radioDevice))
-        {
-            if (radioDevice.interruptCounter > 0)
-            {
-                radioDevice.interruptCounter--;
+        // Refreshes the watchdog only while every subsystem keeps checking in
+        Supervise(&radioDevice);
+        RecordLoopIteration();
 
-                // There was no command to process but an interrupt is pending
-                // This usually indicates e.g. RDS or RSQ interrupt
-                // so schedule the GetIntStatus command
-                GetIntStatus(&radioDevice);
-            }
-        }
+        tud_task();
+        CheckIn(SUBSYSTEM_USB_TASK);
+
+        // Also reads the status byte after each interrupt, and schedules the RDS and RSQ retrievals it calls for
+        ProcessCommand(&radioDevice);
+
+        ProcessScan(&radioDevice);
+        ProcessAntennaCapacitorBenchmark(&radioDevice);
+        ProcessAlternativeFrequencies(&radioDevice);
+        ProcessPropertyBulk(&radioDevice);
+        ReportRadioStatus(&radioDevice);
+        ReportInterruptStatistics(&radioDevice);
+        ReportAudioStatistics(&radioDevice);
+        ReportAudioLevels(&radioDevice);
+        ReportBootMilestones(&radioDevice);
+        ReportFault(&radioDevice);
+        ReportTelemetry(&radioDevice);
+        ReportMemoryUsage(&radioDevice);
+        ProcessSettings(&radioDevice);
+        ProcessPresets(&radioDevice);
 
         ProcessReport(&radioDevice);
     }
@@ -244,6 +226,16 @@ void SystemClock_Config(void)
     HAL_RCCEx_CRSConfig(&RCC_CRSInitStruct);
 }
 
+/**
+ * @brief  Starts receiving I2S data through DMA into the circular buffer
+ * @retval True if the reception was started; false otherwise
+ */
+bool StartAudioCapture(void)
+{
+    // When using circular mode, the size parameter must equal the number of elements in the receiving array
+    return HAL_I2S_Receive_DMA(&hi2s1, &i2sBuffer[0], DMA_BUFFER_LENGTH) == HAL_OK;
+}
+
 /* External callbacks --------------------------------------------------------*/
 
 /**
@@ -256,7 +248,8 @@ void HAL_I2S_RxHalfCpltCallback(I2S_HandleTypeDef *hi2s)
 {
     if (hi2s->Instance == SPI1)
     {
-        tud_audio_write(&i2sBuffer[DMA_BUFFER_START], DMA_BUFFER_LENGTH);
+        WriteAudioSamples(&i2sBuffer[DMA_BUFFER_START], DMA_BUFFER_LENGTH);
+        CheckIn(SUBSYSTEM_AUDIO_DMA);
     }
 }
 
@@ -270,7 +263,8 @@ void HAL_I2S_RxCpltCallback(I2S_HandleTypeDef *hi2s)
 {
     if (hi2s->Instance == SPI1)
     {
-        tud_audio_write(&i2sBuffer[DMA_BUFFER_MIDPOINT], DMA_BUFFER_LENGTH);
+        WriteAudioSamples(&i2sBuffer[DMA_BUFFER_MIDPOINT], DMA_BUFFER_LENGTH);
+        CheckIn(SUBSYSTEM_AUDIO_DMA);
     }
 }
 
@@ -280,11 +274,8 @@ void HAL_I2S_RxCpltCallback(I2S_HandleTypeDef *hi2s)
  */
 void Error_Handler(void)
 {
-    /* User can add his own implementation to report the HAL error return state */
-    __disable_irq();
-    while (1)
-    {
-    }
+    // Record where the error handler was called from, and let the watchdog reset the device
+    RecordFault(FAULT_SOURCE_ERROR_HANDLER, (uint32_t)(uintptr_t)__builtin_return_address(0), 0, 0);
 }
 
 #ifdef USE_FULL_ASSERT
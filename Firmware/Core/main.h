@@ -25,6 +25,7 @@ extern "C"
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f0xx_hal.h"
+#include <stdbool.h>
 
 /* Private includes ----------------------------------------------------------*/
 
@@ -37,6 +38,7 @@ extern "C"
 /* Exported functions prototypes ---------------------------------------------*/
 void Error_Handler(void);
 void SystemClock_Config(void);
+bool StartAudioCapture(void);
 
 /* Private defines -----------------------------------------------------------*/
 #define RADIO_NIRQ_Pin GPIO_PIN_13
@@ -0,0 +1,140 @@
+/**
+ ******************************************************************************
+ * @file    memory.c
+ * @brief   Implements the RAM usage measurement; the free RAM below the stack
+ *          is painted at startup, and scanned for the deepest stack use
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "memory.h"
+#include "main.h"
+#include "tusb.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Symbols defined in the linker script */
+extern uint32_t _sdata;
+extern uint32_t _end;
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+/* Private types -------------------------------------------------------------*/
+
+/* Private constants ---------------------------------------------------------*/
+
+// Pattern painted over the free RAM; a stack frame is unlikely to leave it behind
+#define STACK_PAINT_PATTERN 0xC0DEC0DE
+
+// Interval of the stack high-water scans, in ms
+#define STACK_SCAN_INTERVAL 1000
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+// Lowest address the stack has been found to reach
+uint32_t *stackLowWater = &_estack;
+
+// Tick at which the next scan is due
+uint32_t nextStackScanTick = 0;
+
+// Set when the host has asked for a report, or the stack has grown since the previous one
+volatile bool isMemoryUsageReportPending = true;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Paints the free RAM from the end of the static data up to the
+ *         current stack pointer; must be called first thing in main(), while
+ *         the stack is still shallow
+ */
+void PaintStack(void)
+{
+    // The heap is not used, so everything between the static data and the stack is free
+    volatile uint32_t *word = &_end;
+    uint32_t *stackPointer = (uint32_t *)__get_MSP();
+
+    while (word < stackPointer)
+    {
+        *word++ = STACK_PAINT_PATTERN;
+    }
+}
+
+/**
+ * @brief  Asks for a memory usage report to be sent on the next scan
+ */
+void RequestMemoryUsageReport(void)
+{
+    isMemoryUsageReportPending = true;
+}
+
+/**
+ * @brief  Scans the painted RAM for the deepest stack use, and enqueues the
+ *         RAM usage as a new report when the host has asked for it or the
+ *         stack has grown
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a report was enqueued; false otherwise
+ */
+bool ReportMemoryUsage(RadioDevice_t *device)
+{
+    if ((int32_t)(HAL_GetTick() - nextStackScanTick) < 0)
+    {
+        return false;
+    }
+
+    nextStackScanTick = HAL_GetTick() + STACK_SCAN_INTERVAL;
+
+    // The words below the previous low water are still painted, unless the stack has gone deeper
+    uint32_t *word = &_end;
+
+    while (word < stackLowWater && *word == STACK_PAINT_PATTERN)
+    {
+        word++;
+    }
+
+    if (word < stackLowWater)
+    {
+        stackLowWater = word;
+        isMemoryUsageReportPending = true;
+    }
+
+    if (!isMemoryUsageReportPending || !tud_mounted())
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_MEMORY_USAGE;
+
+    MemoryUsageReport_t *usage = &report.bytes.memoryUsage;
+
+    usage->ramSize = (uint16_t)((uintptr_t)&_estack - (uintptr_t)&_sdata);
+    usage->staticSize = (uint16_t)((uintptr_t)&_end - (uintptr_t)&_sdata);
+    usage->stackReserve = (uint16_t)(uintptr_t)&_Min_Stack_Size;
+    usage->stackHighWater = (uint16_t)((uintptr_t)&_estack - (uintptr_t)stackLowWater);
+    usage->unusedSize = (uint16_t)((uintptr_t)stackLowWater - (uintptr_t)&_end);
+
+    if (!EnqueueReport(device, &report))
+    {
+        // Try again on the next scan
+        return false;
+    }
+
+    isMemoryUsageReportPending = false;
+
+    return true;
+}
@@ -0,0 +1,48 @@
+/**
+ ******************************************************************************
+ * @file    memory.h
+ * @brief   Header for memory.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __MEMORY_H__
+#define __MEMORY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern void PaintStack(void);
+extern void RequestMemoryUsageReport(void);
+extern bool ReportMemoryUsage(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __MEMORY_H__ */
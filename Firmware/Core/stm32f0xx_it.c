@@ -15,6 +15,7 @@
  */
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f0xx_it.h"
+#include "fault.h"
 #include "main.h"
 #include "tusb.h"
 
@@ -42,21 +43,23 @@ extern TIM_HandleTypeDef htim17;
 /**
  * @brief This function handles Non maskable interrupt.
  */
-void NMI_Handler(void)
+__attribute__((naked)) void NMI_Handler(void)
 {
-    while (1)
-    {
-    }
+    // Only the main stack is in use, so it holds the exception stack frame
+    __asm volatile("mrs r0, msp\n"
+                   "ldr r1, =CaptureNonMaskableInterrupt\n"
+                   "bx r1\n");
 }
 
 /**
  * @brief This function handles Hard fault interrupt.
  */
-void HardFault_Handler(void)
+__attribute__((naked)) void HardFault_Handler(void)
 {
-    while (1)
-    {
-    }
+    // Only the main stack is in use, so it holds the exception stack frame
+    __asm volatile("mrs r0, msp\n"
+                   "ldr r1, =CaptureHardFault\n"
+                   "bx r1\n");
 }
 
 /**
@@ -0,0 +1,337 @@
+/**
+ ******************************************************************************
+ * @file    storage.c
+ * @brief   Implements a wear-levelled key/value storage on top of the two
+ *          flash pages reserved by the linker script
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "storage.h"
+#include "main.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+
+/* Private constants ---------------------------------------------------------*/
+
+// Each record is a single flash word: the key in bits 16-23, its complement in
+// bits 24-31, and the value in bits 0-15. The complement lets a record that was
+// torn by a power loss be told apart from a valid one
+#define STORAGE_WORDS_PER_PAGE (FLASH_PAGE_SIZE / sizeof(uint32_t))
+
+// The first word of the active page holds the magic and the generation counter
+#define STORAGE_PAGE_MAGIC 0x5354UL
+#define STORAGE_FIRST_RECORD 1
+
+#define STORAGE_ERASED_WORD 0xFFFFFFFFUL
+
+/* Private macros ------------------------------------------------------------*/
+#define STORAGE_RECORD(key, value) (((uint32_t)(uint8_t)~(key) << 24) | ((uint32_t)(key) << 16) | (uint16_t)(value))
+#define STORAGE_RECORD_KEY(record) ((uint8_t)((record) >> 16))
+#define STORAGE_RECORD_VALUE(record) ((uint16_t)(record))
+#define STORAGE_RECORD_IS_VALID(record) ((uint8_t)((record) >> 24) == (uint8_t)~STORAGE_RECORD_KEY(record))
+
+/* Private variables ---------------------------------------------------------*/
+
+// Provided by the linker script
+extern uint32_t _storage_start[];
+
+// Index of the page that currently holds the records
+uint8_t activeStoragePage = 0;
+
+// Generation counter of the active page; incremented on every compaction
+uint16_t storageGeneration = 0;
+
+// Index of the first erased word in the active page
+uint16_t storageWriteOffset = STORAGE_WORDS_PER_PAGE;
+
+/* Private function prototypes -----------------------------------------------*/
+volatile const uint32_t *GetStoragePage(uint8_t page);
+uint16_t FindWriteOffset(uint8_t page);
+bool ErasePage(uint8_t page);
+bool ProgramWord(uint8_t page, uint16_t offset, uint32_t word);
+bool CompactStorage(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Locates the active storage page, and formats the storage if neither
+ *         page holds valid records
+ *
+ * @retval True if the storage is usable; false otherwise
+ */
+bool StorageInit(void)
+{
+    uint32_t header0 = GetStoragePage(0)[0];
+    uint32_t header1 = GetStoragePage(1)[0];
+
+    bool isValid0 = (header0 >> 16) == STORAGE_PAGE_MAGIC;
+    bool isValid1 = (header1 >> 16) == STORAGE_PAGE_MAGIC;
+
+    if (isValid0 && isValid1)
+    {
+        // A compaction was interrupted before the old page was erased; the newer one wins
+        activeStoragePage = (int16_t)((uint16_t)header1 - (uint16_t)header0) > 0 ? 1 : 0;
+    }
+    else if (isValid0 || isValid1)
+    {
+        activeStoragePage = isValid1 ? 1 : 0;
+    }
+    else
+    {
+        activeStoragePage = 0;
+        storageGeneration = 0;
+
+        if (!ErasePage(0) || !ProgramWord(0, 0, (STORAGE_PAGE_MAGIC << 16) | storageGeneration))
+        {
+            storageWriteOffset = STORAGE_WORDS_PER_PAGE;
+
+            return false;
+        }
+    }
+
+    storageGeneration = (uint16_t)GetStoragePage(activeStoragePage)[0];
+    storageWriteOffset = FindWriteOffset(activeStoragePage);
+
+    return true;
+}
+
+/**
+ * @brief  Reads the most recently written value of the given key
+ * @param  key Key to read
+ * @param  value Pointer to where the value is stored
+ *
+ * @retval True if the key was found; false otherwise
+ */
+bool StorageRead(StorageKey_t key, uint16_t *value)
+{
+    volatile const uint32_t *words = GetStoragePage(activeStoragePage);
+
+    // Records are appended, so the last one is the most recent
+    for (uint16_t i = storageWriteOffset; i > STORAGE_FIRST_RECORD; i--)
+    {
+        uint32_t record = words[i - 1];
+
+        if (STORAGE_RECORD_IS_VALID(record) && STORAGE_RECORD_KEY(record) == key)
+        {
+            *value = STORAGE_RECORD_VALUE(record);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief  Appends a new value for the given key; nothing is written if the
+ *         value has not changed
+ * @param  key Key to write
+ * @param  value Value of the key
+ *
+ * @retval True if the value was stored; false otherwise
+ *
+ * @remark The CPU stalls while the flash is being programmed; when the active
+ *         page fills up, the page erase of the compaction takes tens of ms
+ */
+bool StorageWrite(StorageKey_t key, uint16_t value)
+{
+    if (key == STORAGE_KEY_INVALID)
+    {
+        return false;
+    }
+
+    uint16_t currentValue;
+
+    if (StorageRead(key, &currentValue) && currentValue == value)
+    {
+        return true;
+    }
+
+    if (storageWriteOffset >= STORAGE_WORDS_PER_PAGE && !CompactStorage())
+    {
+        return false;
+    }
+
+    if (storageWriteOffset >= STORAGE_WORDS_PER_PAGE)
+    {
+        // Every record is still in use after the compaction
+        return false;
+    }
+
+    if (!ProgramWord(activeStoragePage, storageWriteOffset, STORAGE_RECORD(key, value)))
+    {
+        // Skip the word; it may have been partially programmed
+        storageWriteOffset++;
+
+        return false;
+    }
+
+    storageWriteOffset++;
+
+    return true;
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Gets the address of the given storage page
+ * @param  page Index of the page, zero or one
+ *
+ * @retval Pointer to the first word of the page
+ */
+volatile const uint32_t *GetStoragePage(uint8_t page)
+{
+    return &_storage_start[page * STORAGE_WORDS_PER_PAGE];
+}
+
+/**
+ * @brief  Finds the first erased word after the last record of the given page
+ * @param  page Index of the page
+ *
+ * @retval Index of the word; equals the number of words in a page if the page is full
+ */
+uint16_t FindWriteOffset(uint8_t page)
+{
+    volatile const uint32_t *words = GetStoragePage(page);
+
+    uint16_t offset = STORAGE_WORDS_PER_PAGE;
+
+    while (offset > STORAGE_FIRST_RECORD && words[offset - 1] == STORAGE_ERASED_WORD)
+    {
+        offset--;
+    }
+
+    return offset;
+}
+
+/**
+ * @brief  Erases the given storage page
+ * @param  page Index of the page
+ *
+ * @retval True if the page was erased; false otherwise
+ */
+bool ErasePage(uint8_t page)
+{
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_PAGES,
+        .PageAddress = (uint32_t)GetStoragePage(page),
+        .NbPages = 1,
+    };
+
+    uint32_t pageError = 0;
+
+    HAL_FLASH_Unlock();
+
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &pageError);
+
+    HAL_FLASH_Lock();
+
+    return status == HAL_OK;
+}
+
+/**
+ * @brief  Programs a single word into the given storage page
+ * @param  page Index of the page
+ * @param  offset Index of the word within the page
+ * @param  word Value to program
+ *
+ * @retval True if the word was programmed; false otherwise
+ */
+bool ProgramWord(uint8_t page, uint16_t offset, uint32_t word)
+{
+    uint32_t address = (uint32_t)&GetStoragePage(page)[offset];
+
+    HAL_FLASH_Unlock();
+
+    HAL_StatusTypeDef status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word);
+
+    HAL_FLASH_Lock();
+
+    return status == HAL_OK;
+}
+
+/**
+ * @brief  Copies the most recent record of every key into the other page, and
+ *         makes it the active page. The header of the new page is written
+ *         last, so a power loss during the compaction leaves the old page active
+ *
+ * @retval True if the compaction succeeded; false otherwise
+ */
+bool CompactStorage(void)
+{
+    uint8_t sourcePage = activeStoragePage;
+    uint8_t targetPage = sourcePage ^ 1;
+
+    volatile const uint32_t *source = GetStoragePage(sourcePage);
+    volatile const uint32_t *target = GetStoragePage(targetPage);
+
+    if (!ErasePage(targetPage))
+    {
+        return false;
+    }
+
+    uint16_t targetOffset = STORAGE_FIRST_RECORD;
+
+    for (uint16_t i = storageWriteOffset; i > STORAGE_FIRST_RECORD; i--)
+    {
+        uint32_t record = source[i - 1];
+
+        if (!STORAGE_RECORD_IS_VALID(record))
+        {
+            continue;
+        }
+
+        // Walking backwards, the first record of each key is the most recent one
+        bool isCopied = false;
+
+        for (uint16_t j = STORAGE_FIRST_RECORD; j < targetOffset; j++)
+        {
+            if (STORAGE_RECORD_KEY(target[j]) == STORAGE_RECORD_KEY(record))
+            {
+                isCopied = true;
+                break;
+            }
+        }
+
+        if (isCopied)
+        {
+            continue;
+        }
+
+        if (!ProgramWord(targetPage, targetOffset, record))
+        {
+            return false;
+        }
+
+        targetOffset++;
+    }
+
+    uint16_t generation = storageGeneration + 1;
+
+    if (!ProgramWord(targetPage, 0, (STORAGE_PAGE_MAGIC << 16) | generation))
+    {
+        return false;
+    }
+
+    activeStoragePage = targetPage;
+    storageGeneration = generation;
+    storageWriteOffset = targetOffset;
+
+    // The old page is left as is to keep the stall short; it is erased by the
+    // next compaction, and the generation counter tells the two apart until then
+    return true;
+}
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file    storage.h
+ * @brief   Header for storage.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __STORAGE_H__
+#define __STORAGE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum _StorageKey_t : uint8_t
+{
+    /* Frequency the radio was last tuned to, in 10 kHz increments */
+    STORAGE_KEY_FREQUENCY = 0x01,
+
+    /* Volume level of the radio */
+    STORAGE_KEY_VOLUME = 0x02,
+
+    /* Mute status of the radio; non-zero when muted */
+    STORAGE_KEY_MUTE = 0x03,
+
+    /* FM de-emphasis setting of the radio */
+    STORAGE_KEY_DEEMPHASIS = 0x04,
+
+    /* First key of the station presets; each preset occupies eight consecutive keys */
+    STORAGE_KEY_PRESET_FIRST = 0x10,
+
+    /* Last key of the station presets */
+    STORAGE_KEY_PRESET_LAST = 0x4F,
+
+    /* Reserved; an erased flash word reads back with this key */
+    STORAGE_KEY_INVALID = 0xFF,
+} StorageKey_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern bool StorageInit(void);
+extern bool StorageRead(StorageKey_t key, uint16_t *value);
+extern bool StorageWrite(StorageKey_t key, uint16_t value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __STORAGE_H__ */
@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file    supervisor.c
+ * @brief   Implements the subsystem supervisor; the watchdog is refreshed only
+ *          while every subsystem keeps checking in, and a subsystem that stops
+ *          is restarted once before the watchdog is left to reset the device
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "supervisor.h"
+#include "antcap.h"
+#include "commands.h"
+#include "fault.h"
+#include "i2s.h"
+#include "main.h"
+#include "scan.h"
+#include "settings.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _SubsystemDescriptor_t
+{
+    /* Longest time the subsystem may go without checking in, in ms */
+    uint16_t deadline;
+
+    /* Restarts the subsystem; NULL when the subsystem cannot be restarted on its own */
+    bool (*restart)(RadioDevice_t *device);
+} SubsystemDescriptor_t;
+
+typedef struct _SubsystemStatus_t
+{
+    /* Set by the first check-in; a subsystem is not supervised before it has started */
+    bool isStarted;
+
+    /* Set by a restart, and cleared by the next check-in */
+    bool isRestarted;
+
+    /* Tick of the latest check-in, or of the latest restart */
+    uint32_t checkInTick;
+
+    /* Number of restarts since reset */
+    uint16_t restartCount;
+} SubsystemStatus_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+// Written by the check-ins, some of which come from interrupts
+volatile SubsystemStatus_t subsystemStatus[SUBSYSTEM_COUNT] = {0};
+
+/* Private function prototypes -----------------------------------------------*/
+bool RestartCommandEngine(RadioDevice_t *device);
+bool RestartAudioCapture(RadioDevice_t *device);
+void ReportSubsystemRestart(RadioDevice_t *device, SupervisedSubsystem_t subsystem);
+
+// clang-format off
+// The audio DMA and the USB task check in every few ms, and the command engine whenever a command completes
+const SubsystemDescriptor_t subsystemDescriptors[SUBSYSTEM_COUNT] = {
+    [SUBSYSTEM_COMMAND_ENGINE] = {.deadline = 1000, .restart = RestartCommandEngine},
+    [SUBSYSTEM_AUDIO_DMA]      = {.deadline = 250,  .restart = RestartAudioCapture},
+    [SUBSYSTEM_USB_TASK]       = {.deadline = 250,  .restart = NULL},
+};
+// clang-format on
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Tells the supervisor that the subsystem is making progress, or is
+ *         idle with nothing to do; may be called from an interrupt
+ * @param  subsystem Subsystem checking in
+ */
+void CheckIn(SupervisedSubsystem_t subsystem)
+{
+    volatile SubsystemStatus_t *status = &subsystemStatus[subsystem];
+
+    status->checkInTick = HAL_GetTick();
+    status->isRestarted = false;
+    status->isStarted = true;
+}
+
+/**
+ * @brief  Checks that every started subsystem has checked in within its
+ *         deadline, and refreshes the watchdog if so; a subsystem that has
+ *         not is restarted, and if it still does not check in, the watchdog
+ *         is left to reset the device
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the watchdog was refreshed; false otherwise
+ */
+bool Supervise(RadioDevice_t *device)
+{
+    for (uint8_t subsystem = 0; subsystem < SUBSYSTEM_COUNT; subsystem++)
+    {
+        volatile SubsystemStatus_t *status = &subsystemStatus[subsystem];
+        const SubsystemDescriptor_t *descriptor = &subsystemDescriptors[subsystem];
+
+        // Read before the tick, so a check-in from an interrupt in between cannot land in the future
+        const uint32_t checkInTick = status->checkInTick;
+
+        if (!status->isStarted || HAL_GetTick() - checkInTick <= descriptor->deadline)
+        {
+            continue;
+        }
+
+        // The restart did not bring the subsystem back, or there is no restart to try
+        if (status->isRestarted || descriptor->restart == NULL)
+        {
+            RecordSubsystemFailure((SupervisedSubsystem_t)subsystem);
+        }
+
+        ReportSubsystemRestart(device, (SupervisedSubsystem_t)subsystem);
+
+        if (!descriptor->restart(device))
+        {
+            RecordSubsystemFailure((SupervisedSubsystem_t)subsystem);
+        }
+
+        // The restart gets a full deadline of its own to check in
+        status->checkInTick = HAL_GetTick();
+        status->isRestarted = true;
+        status->restartCount++;
+    }
+
+    RefreshWatchdog();
+
+    return true;
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Resets the radio and the command engine, and enqueues the commands
+ *         that bring the radio back to the state it had
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the commands were enqueued; false otherwise
+ */
+bool RestartCommandEngine(RadioDevice_t *device)
+{
+    // The scan and the benchmark wait for the results of the commands that are about to be dropped
+    AbortScan();
+    AbortAntennaCapacitorBenchmark(device);
+
+    ResetCommandEngine(device);
+
+    return StartRadio(device) && ReapplySettings(device);
+}
+
+/**
+ * @brief  Stops the I2S DMA and starts it again
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the reception was started again; false otherwise
+ */
+bool RestartAudioCapture(RadioDevice_t *device)
+{
+    UNUSED(device);
+
+    HAL_I2S_DMAStop(&hi2s1);
+
+    return StartAudioCapture();
+}
+
+/**
+ * @brief  Enqueues the subsystem about to be restarted as a new report, along
+ *         with the command the engine was stuck on
+ * @param  device Pointer to the radio device structure
+ * @param  subsystem Subsystem about to be restarted
+ */
+void ReportSubsystemRestart(RadioDevice_t *device, SupervisedSubsystem_t subsystem)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_SUBSYSTEM_RESTART;
+
+    SubsystemRestartReport_t *restart = &report.bytes.subsystemRestart;
+
+    restart->subsystem = subsystem;
+    restart->restartCount = subsystemStatus[subsystem].restartCount + 1;
+
+    CommandQueue_t *queue = &device->commandQueue;
+
+    if (queue->count > 0)
+    {
+        restart->commandOpCode = queue->commands[queue->front].args.opCode;
+        restart->commandState = queue->commands[queue->front].state;
+    }
+
+    EnqueueReport(device, &report);
+}
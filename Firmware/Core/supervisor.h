@@ -0,0 +1,48 @@
+/**
+ ******************************************************************************
+ * @file    supervisor.h
+ * @brief   Header for supervisor.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __SUPERVISOR_H__
+#define __SUPERVISOR_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include "reports.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern void CheckIn(SupervisedSubsystem_t subsystem);
+extern bool Supervise(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SUPERVISOR_H__ */
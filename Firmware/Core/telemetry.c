@@ -0,0 +1,331 @@
+/**
+ ******************************************************************************
+ * @file    telemetry.c
+ * @brief   Implements the firmware runtime telemetry: main loop rate, queue
+ *          high-water marks, dropped enqueues, command latency and I2C load
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "telemetry.h"
+#include "main.h"
+#include "tim.h"
+#include "tusb.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _CommandLatencyStatistics_t
+{
+    /* Opcode of the command; zero if the slot is free */
+    uint8_t opCode;
+
+    /* Number of commands completed during the window */
+    uint16_t count;
+
+    /* Shortest and longest latency during the window, in µs */
+    uint16_t minimum;
+    uint16_t maximum;
+
+    /* Sum of the latencies during the window, in µs */
+    uint32_t total;
+} CommandLatencyStatistics_t;
+
+typedef struct _Telemetry_t
+{
+    /* Tick at which the current window began */
+    uint32_t windowStartTick;
+
+    /* Number of main loop iterations during the window, and the time the previous one began, in µs */
+    uint32_t loopIterations;
+    uint32_t previousLoopMicroseconds;
+
+    /* Longest main loop iteration during the window, in µs */
+    uint32_t maximumLoopPeriod;
+
+    /* Highest queue counts during the window */
+    uint8_t commandQueueHighWater;
+    uint8_t reportQueueHighWater;
+
+    /* Total number of enqueues that did not fit */
+    uint16_t droppedCommands;
+    uint16_t droppedReports;
+
+    /* Time the I2C bus has been transferring during the window, and the start of the transfer in progress, in µs */
+    uint32_t i2cBusyMicroseconds;
+    uint32_t i2cStartMicroseconds;
+
+    /* Latency of the commands sent during the window */
+    CommandLatencyStatistics_t commands[TELEMETRY_COMMAND_COUNT];
+} Telemetry_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+// Shortest interval of the periodic telemetry reports, in ms
+#define TELEMETRY_INTERVAL_MIN 100
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+// Counters of the current window
+volatile Telemetry_t telemetry = {0};
+
+// Interval of the periodic reports, in ms; zero sends them only on request
+uint16_t telemetryInterval = 0;
+
+// Tick at which the next periodic report is due
+uint32_t nextTelemetryTick = 0;
+
+// Set when the host has asked for a report
+volatile bool isTelemetryRequested = false;
+
+/* Private function prototypes -----------------------------------------------*/
+void ResetTelemetryWindow(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Records the start of a main loop iteration
+ */
+void RecordLoopIteration(void)
+{
+    uint32_t now = GetMicroseconds();
+
+    if (telemetry.loopIterations > 0)
+    {
+        uint32_t period = now - telemetry.previousLoopMicroseconds;
+
+        if (period > telemetry.maximumLoopPeriod)
+        {
+            telemetry.maximumLoopPeriod = period;
+        }
+    }
+
+    telemetry.previousLoopMicroseconds = now;
+    telemetry.loopIterations++;
+}
+
+/**
+ * @brief  Records the number of entries in a queue after an enqueue
+ * @param  queue Queue that was enqueued to
+ * @param  count Number of entries in the queue
+ */
+void RecordQueueDepth(TelemetryQueue_t queue, uint8_t count)
+{
+    if (queue == TELEMETRY_QUEUE_COMMAND && count > telemetry.commandQueueHighWater)
+    {
+        telemetry.commandQueueHighWater = count;
+    }
+    else if (queue == TELEMETRY_QUEUE_REPORT && count > telemetry.reportQueueHighWater)
+    {
+        telemetry.reportQueueHighWater = count;
+    }
+}
+
+/**
+ * @brief  Records an enqueue that did not fit into a full queue
+ * @param  queue Queue that was full
+ */
+void RecordDroppedEnqueue(TelemetryQueue_t queue)
+{
+    volatile uint16_t *counter =
+        queue == TELEMETRY_QUEUE_COMMAND ? &telemetry.droppedCommands : &telemetry.droppedReports;
+
+    if (*counter < UINT16_MAX)
+    {
+        (*counter)++;
+    }
+}
+
+/**
+ * @brief  Records the start of an I2C transfer
+ */
+void RecordI2CTransferStart(void)
+{
+    telemetry.i2cStartMicroseconds = GetMicroseconds();
+}
+
+/**
+ * @brief  Records the completion of the I2C transfer in progress
+ */
+void RecordI2CTransferComplete(void)
+{
+    telemetry.i2cBusyMicroseconds += GetMicroseconds() - telemetry.i2cStartMicroseconds;
+}
+
+/**
+ * @brief  Records the time a command took from being sent to its completion
+ * @param  opCode Opcode of the command
+ * @param  latency Latency of the command, in µs
+ */
+void RecordCommandLatency(CommandIdentifiers_t opCode, uint32_t latency)
+{
+    if (latency > UINT16_MAX)
+    {
+        latency = UINT16_MAX;
+    }
+
+    for (uint8_t i = 0; i < TELEMETRY_COMMAND_COUNT; i++)
+    {
+        volatile CommandLatencyStatistics_t *command = &telemetry.commands[i];
+
+        // The commands take the free slots in the order they are first sent
+        if (command->opCode == 0)
+        {
+            command->opCode = opCode;
+            command->minimum = UINT16_MAX;
+        }
+        else if (command->opCode != opCode)
+        {
+            continue;
+        }
+
+        if (command->count < UINT16_MAX)
+        {
+            command->count++;
+            command->total += latency;
+        }
+
+        if (latency < command->minimum)
+        {
+            command->minimum = (uint16_t)latency;
+        }
+
+        if (latency > command->maximum)
+        {
+            command->maximum = (uint16_t)latency;
+        }
+
+        return;
+    }
+
+    // Every slot is taken by other commands; this one is left out of the window
+}
+
+/**
+ * @brief  Sends a telemetry report right away, and sets the pace of the periodic reports
+ * @param  request Pointer to the request
+ */
+void ConfigureTelemetry(const TelemetryRequest_t *request)
+{
+    telemetryInterval = request->interval;
+
+    if (telemetryInterval != 0 && telemetryInterval < TELEMETRY_INTERVAL_MIN)
+    {
+        telemetryInterval = TELEMETRY_INTERVAL_MIN;
+    }
+
+    isTelemetryRequested = true;
+}
+
+/**
+ * @brief  Enqueues the telemetry of the current window as a new report when
+ *         the host has asked for it or a periodic report is due, and starts a
+ *         new window
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a report was enqueued; false otherwise
+ */
+bool ReportTelemetry(RadioDevice_t *device)
+{
+    uint32_t now = HAL_GetTick();
+
+    bool isDue = telemetryInterval != 0 && (int32_t)(now - nextTelemetryTick) >= 0;
+
+    if (!isTelemetryRequested && !isDue)
+    {
+        return false;
+    }
+
+    // Waiting for room keeps the report itself from counting as a dropped one
+    if (!tud_mounted() || device->reportQueue.count >= MAX_REPORT_QUEUE_CAPACITY)
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_TELEMETRY;
+
+    FillTelemetryReport(&report.bytes.telemetry);
+
+    EnqueueReport(device, &report);
+
+    isTelemetryRequested = false;
+    nextTelemetryTick = now + telemetryInterval;
+
+    ResetTelemetryWindow();
+
+    return true;
+}
+
+/**
+ * @brief  Fills in the telemetry report from the window so far, without
+ *         starting a new window
+ * @param  summary Pointer to the zeroed report to fill in
+ */
+void FillTelemetryReport(TelemetryReport_t *summary)
+{
+    uint32_t window = HAL_GetTick() - telemetry.windowStartTick;
+
+    if (window > 0)
+    {
+        // Split to stay clear of both overflow and a 64-bit division
+        summary->loopRate = (telemetry.loopIterations / window) * 1000 +
+                            ((telemetry.loopIterations % window) * 1000) / window;
+
+        uint32_t i2cBusy = (telemetry.i2cBusyMicroseconds / 10) / window;
+
+        summary->i2cBusy = (uint8_t)(i2cBusy > 100 ? 100 : i2cBusy);
+    }
+
+    summary->window = window > UINT16_MAX ? UINT16_MAX : (uint16_t)window;
+    summary->maximumLoopPeriod = telemetry.maximumLoopPeriod;
+    summary->commandQueueHighWater = telemetry.commandQueueHighWater;
+    summary->reportQueueHighWater = telemetry.reportQueueHighWater;
+    summary->droppedCommands = telemetry.droppedCommands;
+    summary->droppedReports = telemetry.droppedReports;
+
+    for (uint8_t i = 0; i < TELEMETRY_COMMAND_COUNT && telemetry.commands[i].opCode != 0; i++)
+    {
+        volatile CommandLatencyStatistics_t *command = &telemetry.commands[i];
+
+        summary->commands[i].opCode = command->opCode;
+        summary->commands[i].count = command->count;
+        summary->commands[i].minimum = command->minimum;
+        summary->commands[i].average = (uint16_t)(command->total / command->count);
+        summary->commands[i].maximum = command->maximum;
+
+        summary->commandCount++;
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Starts a new telemetry window; the dropped enqueues are totals, and are kept
+ */
+void ResetTelemetryWindow(void)
+{
+    telemetry.windowStartTick = HAL_GetTick();
+    telemetry.loopIterations = 0;
+    telemetry.maximumLoopPeriod = 0;
+    telemetry.commandQueueHighWater = 0;
+    telemetry.reportQueueHighWater = 0;
+    telemetry.i2cBusyMicroseconds = 0;
+
+    for (uint8_t i = 0; i < TELEMETRY_COMMAND_COUNT; i++)
+    {
+        telemetry.commands[i] = (CommandLatencyStatistics_t){0};
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * @file    telemetry.h
+ * @brief   Header for telemetry.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "common.h"
+#include "device.h"
+#include "reports.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum _TelemetryQueue_t : uint8_t
+{
+    /* The command queue of the radio device */
+    TELEMETRY_QUEUE_COMMAND = 0x00,
+
+    /* The report queue of the radio device */
+    TELEMETRY_QUEUE_REPORT = 0x01,
+} TelemetryQueue_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern void RecordLoopIteration(void);
+extern void RecordQueueDepth(TelemetryQueue_t queue, uint8_t count);
+extern void RecordDroppedEnqueue(TelemetryQueue_t queue);
+extern void RecordI2CTransferStart(void);
+extern void RecordI2CTransferComplete(void);
+extern void RecordCommandLatency(CommandIdentifiers_t opCode, uint32_t latency);
+extern void ConfigureTelemetry(const TelemetryRequest_t *request);
+extern void FillTelemetryReport(TelemetryReport_t *summary);
+extern bool ReportTelemetry(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TELEMETRY_H__ */
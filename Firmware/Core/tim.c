@@ -17,9 +17,29 @@
 /* Includes ------------------------------------------------------------------*/
 #include "tim.h"
 
+TIM_HandleTypeDef htim2;
 TIM_HandleTypeDef htim16;
 TIM_HandleTypeDef htim17;
 
+/* TIM2 init function */
+void MX_TIM2_Init(void)
+{
+    // TIM2 is a free-running 32-bit counter ticking every 5 µs; the 38.4 MHz timer clock has no
+    // prescaler for an exact microsecond, so GetMicroseconds() scales the count
+    htim2.Instance = TIM2;
+    htim2.Init.Prescaler = 191;
+    htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim2.Init.Period = 0xFFFFFFFF;
+    htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim2.Init.RepetitionCounter = 0;
+    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+    if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
 /* TIM16 init function */
 void MX_TIM16_Init(void)
 {
@@ -56,7 +76,12 @@ void MX_TIM17_Init(void)
 
 void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim)
 {
-    if (htim->Instance == TIM16)
+    if (htim->Instance == TIM2)
+    {
+        /* TIM2 clock enable; the counter is polled so no interrupt is needed */
+        __HAL_RCC_TIM2_CLK_ENABLE();
+    }
+    else if (htim->Instance == TIM16)
     {
         /* TIM16 clock enable */
         __HAL_RCC_TIM16_CLK_ENABLE();
@@ -78,7 +103,12 @@ void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim)
 
 void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef *htim)
 {
-    if (htim->Instance == TIM16)
+    if (htim->Instance == TIM2)
+    {
+        /* Peripheral clock disable */
+        __HAL_RCC_TIM2_CLK_DISABLE();
+    }
+    else if (htim->Instance == TIM16)
     {
         /* Peripheral clock disable */
         __HAL_RCC_TIM16_CLK_DISABLE();
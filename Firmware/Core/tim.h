@@ -26,12 +26,29 @@ extern "C"
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 
+extern TIM_HandleTypeDef htim2;
 extern TIM_HandleTypeDef htim16;
 extern TIM_HandleTypeDef htim17;
 
+void MX_TIM2_Init(void);
 void MX_TIM16_Init(void);
 void MX_TIM17_Init(void);
 
+// Length of a TIM2 tick, in µs
+#define TIM2_TICK_MICROSECONDS 5
+
+/**
+ * @brief  Reads the free-running microsecond counter, in 5 µs steps
+ * @retval Microseconds elapsed since TIM2 was started; wraps around after roughly 71 minutes
+ *
+ * @remark The scaled count wraps around cleanly, as 2^32 ticks are a whole
+ *         number of 2^32 µs wrap-arounds; differences stay exact across it
+ */
+static inline uint32_t GetMicroseconds(void)
+{
+    return htim2.Instance->CNT * TIM2_TICK_MICROSECONDS;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,16 +20,55 @@
 
 /* Includes ------------------------------------------------------------------*/
 #if defined __cplusplus
+#include <QList>
+#include <QVariantList>
 #include <QtQml/qqmlregistration.h>
 #endif /* __cplusplus */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* The HID report size includes the identifier and the struct bytes */
 #define MAX_REPORT_SIZE 128
 #define MAX_STRUCT_SIZE MAX_REPORT_SIZE - 1
 
+/* Every report the device sends ends in an envelope after the struct bytes; see ReportEnvelope_t */
+#define REPORT_ENVELOPE_OFFSET 120
+#define REPORT_ENVELOPE_SIZE 7
+#define MAX_PAYLOAD_SIZE REPORT_ENVELOPE_OFFSET
+
+/* Number of buckets in the audio FIFO fill level histogram */
+#define AUDIO_FIFO_HISTOGRAM_BUCKETS 8
+
+/* Number of audio channels covered by the level metering */
+#define AUDIO_LEVEL_CHANNELS 2
+
+/* Number of station presets stored on the device */
+#define PRESET_COUNT 8
+
+/* Number of alternative frequencies collected from the RDS of the current station */
+#define ALTERNATIVE_FREQUENCY_COUNT 12
+
+/* Number of properties carried by one bulk property request or report */
+#define PROPERTY_BULK_COUNT 28
+
+/* Number of radio interrupt sources covered by the interrupt statistics; CTS, STC, RDS, RSQ and ERR */
+#define INTERRUPT_SOURCE_COUNT 5
+
+/* Number of radio commands whose latency is tracked by the telemetry report */
+#define TELEMETRY_COMMAND_COUNT 10
+
+/* Number of command macro slots the host can fill, and the number of commands in one macro */
+#define MACRO_SLOT_COUNT 4
+#define MACRO_RECORD_COUNT 8
+
+/* Identifier of the built-in macro that powers up and configures the radio; the stored macros use the slot numbers */
+#define MACRO_ID_BOOT 0x80
+
+/* Marks that no command of a macro was rejected */
+#define MACRO_INDEX_NONE 0xFF
+
 /* Exported types */
 typedef enum _ReportIdentifier_t : uint8_t
 {
@@ -51,11 +90,119 @@ typedef enum _ReportIdentifier_t : uint8_t
     /* Identifies a report that provides stable Radio Text information */
     REPORT_IDENTIFIER_RDS_RADIO_TEXT = 0x06,
 
+    /* Identifies a report that provides audio pipeline health counters */
+    REPORT_IDENTIFIER_AUDIO_STATISTICS = 0x07,
+
+    /* Identifies a report that provides the peak and RMS audio levels */
+    REPORT_IDENTIFIER_AUDIO_LEVELS = 0x08,
+
+    /* Identifies a report that provides the boot milestone timings */
+    REPORT_IDENTIFIER_BOOT_MILESTONES = 0x09,
+
+    /* Identifies a report that lists the station presets */
+    REPORT_IDENTIFIER_PRESET_LIST = 0x0A,
+
+    /* Identifies a report that provides a batch of band scan results */
+    REPORT_IDENTIFIER_SCAN_RESULTS = 0x0B,
+
+    /* Identifies a report that summarizes a completed band scan */
+    REPORT_IDENTIFIER_SCAN_SUMMARY = 0x0C,
+
+    /* Identifies a report that provides the progress of a seek */
+    REPORT_IDENTIFIER_SEEK_PROGRESS = 0x0D,
+
+    /* Identifies a report that provides the results of the antenna tuning capacitor benchmark */
+    REPORT_IDENTIFIER_ANTCAP_BENCHMARK = 0x0E,
+
+    /* Identifies a report that provides the signal quality right after a tune or seek */
+    REPORT_IDENTIFIER_TUNE_STATUS = 0x0F,
+
+    /* Identifies a report that provides the alternative frequencies and the statistics of following them */
+    REPORT_IDENTIFIER_AF_STATUS = 0x10,
+
+    /* Identifies a report that provides the results of a bulk property set or get */
+    REPORT_IDENTIFIER_PROPERTY_BULK_RESULT = 0x11,
+
+    /* Identifies a report that provides the radio interrupt servicing counters */
+    REPORT_IDENTIFIER_INTERRUPT_STATISTICS = 0x12,
+
+    /* Identifies a report that provides the firmware runtime telemetry */
+    REPORT_IDENTIFIER_TELEMETRY = 0x13,
+
+    /* Identifies a report that provides the RAM usage, including the stack high-water mark */
+    REPORT_IDENTIFIER_MEMORY_USAGE = 0x14,
+
+    /* Device sends the fault record left behind by the previous run, after a fault or watchdog reset */
+    REPORT_IDENTIFIER_FAULT = 0x15,
+
+    /* Device sends the subsystem the supervisor restarted after it stopped making progress */
+    REPORT_IDENTIFIER_SUBSYSTEM_RESTART = 0x16,
+
+    /* Device sends the response of a command the host passed through to the radio */
+    REPORT_IDENTIFIER_PASSTHROUGH_RESPONSE = 0x17,
+
+    /* Device sends the outcome of a command macro once its last command has completed, or when it could not run */
+    REPORT_IDENTIFIER_MACRO_COMPLETION = 0x18,
+
     /* Indicates a request to tune to a new frequency */
     REPORT_IDENTIFIER_TUNE_FREQ = 0x20,
 
     /* Indicates a request to begin seeking the next station */
     REPORT_IDENTIFIER_SEEK_START = 0x21,
+
+    /* Identifies a request to change the audio level metering window */
+    REPORT_IDENTIFIER_SET_AUDIO_LEVEL_WINDOW = 0x22,
+
+    /* Identifies a request to store a station preset */
+    REPORT_IDENTIFIER_PRESET_STORE = 0x23,
+
+    /* Identifies a request to list the station presets */
+    REPORT_IDENTIFIER_PRESET_LIST_REQUEST = 0x24,
+
+    /* Identifies a request to tune to a station preset */
+    REPORT_IDENTIFIER_PRESET_RECALL = 0x25,
+
+    /* Identifies a request to start a band scan */
+    REPORT_IDENTIFIER_SCAN_START = 0x26,
+
+    /* Identifies a request to stop a band scan */
+    REPORT_IDENTIFIER_SCAN_STOP = 0x27,
+
+    /* Identifies a request to cancel the seek in progress */
+    REPORT_IDENTIFIER_SEEK_CANCEL = 0x28,
+
+    /* Identifies a request to benchmark the tune times with and without the antenna tuning capacitor cache */
+    REPORT_IDENTIFIER_ANTCAP_BENCHMARK_START = 0x29,
+
+    /* Identifies a request to configure the following of alternative frequencies */
+    REPORT_IDENTIFIER_AF_CONFIG = 0x2A,
+
+    /* Identifies a request to override the RF AGC with a fixed LNA gain index */
+    REPORT_IDENTIFIER_AGC_OVERRIDE = 0x2B,
+
+    /* Identifies a request to set many properties at once */
+    REPORT_IDENTIFIER_PROPERTY_SET_BULK = 0x2C,
+
+    /* Identifies a request to get many properties at once */
+    REPORT_IDENTIFIER_PROPERTY_GET_BULK = 0x2D,
+
+    /* Identifies a request for a telemetry report, and for the pace of the periodic ones */
+    REPORT_IDENTIFIER_TELEMETRY_REQUEST = 0x2E,
+
+    /* Identifies a request to set the pace of the radio status reports sent when nothing has changed */
+    REPORT_IDENTIFIER_RADIO_STATUS_HEARTBEAT = 0x2F,
+
+    /* Identifies a request to pass a command through to the radio as it is */
+    REPORT_IDENTIFIER_PASSTHROUGH = 0x30,
+
+    /* Identifies a request to store a command macro in one of the macro slots */
+    REPORT_IDENTIFIER_MACRO_STORE = 0x31,
+
+    /* Identifies a request to run a stored or a built-in command macro */
+    REPORT_IDENTIFIER_MACRO_RUN = 0x32,
+
+    /* Identifies a request to select the report the feature report returns a snapshot of */
+    REPORT_IDENTIFIER_SNAPSHOT_SELECT = 0x33,
 } ReportIdentifier_t;
 
 typedef enum _RadioState_t : uint8_t
@@ -76,6 +223,75 @@ typedef enum _RadioState_t : uint8_t
     RADIOSTATE_DIGITAL_OUTPUT_ENABLED = 0x04,
 } RadioState_t;
 
+typedef enum _FaultSource_t : uint8_t
+{
+    /* No fault has been recorded */
+    FAULT_SOURCE_NONE = 0x00,
+
+    /* The processor raised a hard fault */
+    FAULT_SOURCE_HARD_FAULT = 0x01,
+
+    /* The clock security system raised a non-maskable interrupt */
+    FAULT_SOURCE_NMI = 0x02,
+
+    /* Initialization failed, and the error handler was called */
+    FAULT_SOURCE_ERROR_HANDLER = 0x03,
+
+    /* The main loop stopped refreshing the watchdog */
+    FAULT_SOURCE_WATCHDOG = 0x04,
+
+    /* A supervised subsystem stopped making progress, and restarting it did not help */
+    FAULT_SOURCE_SUPERVISOR = 0x05,
+} FaultSource_t;
+
+typedef enum _SupervisedSubsystem_t : uint8_t
+{
+    /* The command engine, which sends the commands to the radio and collects their responses */
+    SUBSYSTEM_COMMAND_ENGINE = 0x00,
+
+    /* The I2S DMA, which captures the audio from the radio */
+    SUBSYSTEM_AUDIO_DMA = 0x01,
+
+    /* The TinyUSB device task */
+    SUBSYSTEM_USB_TASK = 0x02,
+
+    /* Number of subsystems; not a subsystem itself */
+    SUBSYSTEM_COUNT = 0x03,
+} SupervisedSubsystem_t;
+
+typedef enum _PassthroughResult_t : uint8_t
+{
+    /* The command completed; the status byte tells whether the radio accepted it */
+    PASSTHROUGH_RESULT_COMPLETED = 0x00,
+
+    /* The command queue was full, and the command was not sent */
+    PASSTHROUGH_RESULT_QUEUE_FULL = 0x01,
+
+    /* The argument or the response length was out of range, and the command was not sent */
+    PASSTHROUGH_RESULT_INVALID = 0x02,
+} PassthroughResult_t;
+
+typedef enum _MacroResult_t : uint8_t
+{
+    /* Every command of the macro completed, and the radio accepted them */
+    MACRO_RESULT_COMPLETED = 0x00,
+
+    /* Every command of the macro completed, but the radio rejected at least one of them */
+    MACRO_RESULT_FAILED = 0x01,
+
+    /* Another macro was still running, and the macro was not run */
+    MACRO_RESULT_BUSY = 0x02,
+
+    /* The command queue did not have room for the whole macro, and the macro was not run */
+    MACRO_RESULT_QUEUE_FULL = 0x03,
+
+    /* The macro does not exist or has no commands, and was not run */
+    MACRO_RESULT_EMPTY = 0x04,
+
+    /* The command engine was restarted before the macro completed */
+    MACRO_RESULT_ABORTED = 0x05,
+} MacroResult_t;
+
 typedef struct _RadioStatusResponse_t
 {
 #if defined __cplusplus
@@ -108,7 +324,7 @@ typedef struct _RadioStatusResponse_t
     bool isMuted;
 } RadioStatusResponse_t;
 
-static_assert(sizeof(RadioStatusResponse_t) <= MAX_STRUCT_SIZE);
+static_assert(sizeof(RadioStatusResponse_t) <= MAX_PAYLOAD_SIZE);
 
 typedef struct _GetIntStatusResponse_t
 {
@@ -140,7 +356,7 @@ typedef struct _GetIntStatusResponse_t
     bool seekTuneCompletedInterrupt;
 } GetIntStatusResponse_t;
 
-static_assert(sizeof(GetIntStatusResponse_t) <= MAX_STRUCT_SIZE);
+static_assert(sizeof(GetIntStatusResponse_t) <= MAX_PAYLOAD_SIZE);
 
 typedef struct _GetPropertyResponse_t
 {
@@ -156,7 +372,7 @@ typedef struct _GetPropertyResponse_t
     uint16_t propertyValue;
 } GetPropertyResponse_t;
 
-static_assert(sizeof(GetPropertyResponse_t) <= MAX_STRUCT_SIZE);
+static_assert(sizeof(GetPropertyResponse_t) <= MAX_PAYLOAD_SIZE);
 
 typedef struct _RSQStatusResponse_t
 {
@@ -179,6 +395,8 @@ typedef struct _RSQStatusResponse_t
     Q_PROPERTY(uint8_t snr MEMBER snr)
     Q_PROPERTY(uint8_t multipath MEMBER multipath)
     Q_PROPERTY(int8_t frequencyOffset MEMBER frequencyOffset)
+    Q_PROPERTY(bool isAGCDisabled MEMBER isAGCDisabled)
+    Q_PROPERTY(uint8_t lnaGainIndex MEMBER lnaGainIndex)
 
   public:
 #endif /* __cplusplus */
@@ -230,9 +448,15 @@ typedef struct _RSQStatusResponse_t
 
     /* Contains the signed frequency offset, in kHz */
     int8_t frequencyOffset;
+
+    /* When set, the RF AGC is disabled and the LNA gain index has been set by the host */
+    bool isAGCDisabled;
+
+    /* Contains the LNA gain index in use (0 = minimum attenuation, 26 = maximum attenuation) */
+    uint8_t lnaGainIndex;
 } RSQStatusResponse_t;
 
-static_assert(sizeof(RSQStatusResponse_t) <= MAX_STRUCT_SIZE);
+static_assert(sizeof(RSQStatusResponse_t) <= MAX_PAYLOAD_SIZE);
 
 typedef struct _RDSProgrammeServiceReport_t
 {
@@ -252,7 +476,7 @@ typedef struct _RDSProgrammeServiceReport_t
     char programmeService[8];
 } RDSProgrammeServiceReport_t;
 
-static_assert(sizeof(RDSProgrammeServiceReport_t) <= MAX_STRUCT_SIZE);
+static_assert(sizeof(RDSProgrammeServiceReport_t) <= MAX_PAYLOAD_SIZE);
 
 typedef struct _RDSRadioTextReport_t
 {
@@ -272,7 +496,826 @@ typedef struct _RDSRadioTextReport_t
     char radioText[64];
 } RDSRadioTextReport_t;
 
-static_assert(sizeof(RDSRadioTextReport_t) <= MAX_STRUCT_SIZE);
+static_assert(sizeof(RDSRadioTextReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _AudioStatisticsReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(bool isStreaming MEMBER isStreaming)
+    Q_PROPERTY(uint32_t droppedSamples MEMBER droppedSamples)
+    Q_PROPERTY(uint32_t shortWrites MEMBER shortWrites)
+    Q_PROPERTY(uint32_t underruns MEMBER underruns)
+    Q_PROPERTY(uint16_t callbackCount MEMBER callbackCount)
+    Q_PROPERTY(uint16_t expectedCallbackPeriod MEMBER expectedCallbackPeriod)
+    Q_PROPERTY(uint16_t minimumCallbackPeriod MEMBER minimumCallbackPeriod)
+    Q_PROPERTY(uint16_t maximumCallbackPeriod MEMBER maximumCallbackPeriod)
+    Q_PROPERTY(QList<int> fifoFillHistogram READ GetFifoFillHistogram)
+
+  public:
+    QList<int> GetFifoFillHistogram() const
+    {
+        return QList<int>(std::begin(fifoFillHistogram), std::end(fifoFillHistogram));
+    }
+#endif /* __cplusplus */
+
+    /* When set, the host has opened the audio stream */
+    bool isStreaming;
+
+    /* Total number of samples that did not fit into the USB FIFO while streaming */
+    uint32_t droppedSamples;
+
+    /* Total number of USB FIFO writes that were shorter than requested while streaming */
+    uint32_t shortWrites;
+
+    /* Total number of times the USB FIFO was found empty while streaming */
+    uint32_t underruns;
+
+    /* Number of DMA half/full callbacks since the previous report */
+    uint16_t callbackCount;
+
+    /* Nominal period between DMA callbacks, in µs */
+    uint16_t expectedCallbackPeriod;
+
+    /* Shortest period between DMA callbacks since the previous report, in µs */
+    uint16_t minimumCallbackPeriod;
+
+    /* Longest period between DMA callbacks since the previous report, in µs */
+    uint16_t maximumCallbackPeriod;
+
+    /* USB FIFO fill level sampled at each DMA callback since the previous report; bucket N
+     * counts the samples where the FIFO was between N/8 and (N+1)/8 full */
+    uint16_t fifoFillHistogram[AUDIO_FIFO_HISTOGRAM_BUCKETS];
+} AudioStatisticsReport_t;
+
+static_assert(sizeof(AudioStatisticsReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _AudioLevelReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t window MEMBER window)
+    Q_PROPERTY(uint16_t peakLeft MEMBER peakLeft)
+    Q_PROPERTY(uint16_t peakRight MEMBER peakRight)
+    Q_PROPERTY(uint16_t rmsLeft MEMBER rmsLeft)
+    Q_PROPERTY(uint16_t rmsRight MEMBER rmsRight)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Length of the window the levels were measured over, in ms */
+    uint16_t window;
+
+    /* Largest absolute sample value of the left channel; full scale is 32767 */
+    uint16_t peakLeft;
+
+    /* Largest absolute sample value of the right channel; full scale is 32767 */
+    uint16_t peakRight;
+
+    /* Root mean square of the left channel samples; full scale is 32767 */
+    uint16_t rmsLeft;
+
+    /* Root mean square of the right channel samples; full scale is 32767 */
+    uint16_t rmsRight;
+} AudioLevelReport_t;
+
+static_assert(sizeof(AudioLevelReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _BootMilestonesReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint32_t enumerated MEMBER enumerated)
+    Q_PROPERTY(uint32_t oscillatorReady MEMBER oscillatorReady)
+    Q_PROPERTY(uint32_t radioReady MEMBER radioReady)
+    Q_PROPERTY(uint32_t firstAudio MEMBER firstAudio)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Time at which the host configured the USB device, in ms since reset; zero if not reached */
+    uint32_t enumerated;
+
+    /* Time at which the radio oscillator had started up, in ms since reset; zero if not reached */
+    uint32_t oscillatorReady;
+
+    /* Time at which the radio enabled its digital audio output, in ms since reset; zero if not reached */
+    uint32_t radioReady;
+
+    /* Time at which radio audio was first delivered to a streaming host, in ms since reset; zero if not reached */
+    uint32_t firstAudio;
+} BootMilestonesReport_t;
+
+static_assert(sizeof(BootMilestonesReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _Preset_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t frequency MEMBER frequency)
+    Q_PROPERTY(uint16_t programmeIdentification MEMBER programmeIdentification)
+    Q_PROPERTY(QString programmeService READ GetProgrammeService)
+    Q_PROPERTY(uint8_t antennaCapacitor MEMBER antennaCapacitor)
+
+  public:
+    QString GetProgrammeService() const
+    {
+        return QString::fromLatin1(programmeService, 8).trimmed();
+    }
+#endif /* __cplusplus */
+
+    /* Frequency of the station, in 10 kHz increments; zero if the preset is empty */
+    uint16_t frequency;
+
+    /* Programme Identification (PI) code of the station; zero if unknown */
+    uint16_t programmeIdentification;
+
+    /* Last known Programme Service (PS) name of the station */
+    char programmeService[8];
+
+    /* Antenna tuning capacitor value of the station; zero selects it automatically */
+    uint8_t antennaCapacitor;
+} Preset_t;
+
+typedef struct _PresetListReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(QVariantList presets READ GetPresets)
+
+  public:
+    QVariantList GetPresets() const
+    {
+        QVariantList list;
+
+        for (uint8_t i = 0; i < count && i < PRESET_COUNT; i++)
+        {
+            list.append(QVariant::fromValue(presets[i]));
+        }
+
+        return list;
+    }
+#endif /* __cplusplus */
+
+    /* Number of presets in the list */
+    uint8_t count;
+
+    /* Station presets, indexed by their slot */
+    Preset_t presets[PRESET_COUNT];
+} PresetListReport_t;
+
+static_assert(sizeof(PresetListReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _ScanRecord_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t frequency MEMBER frequency)
+    Q_PROPERTY(uint8_t rssi MEMBER rssi)
+    Q_PROPERTY(uint8_t snr MEMBER snr)
+    Q_PROPERTY(uint8_t multipath MEMBER multipath)
+    Q_PROPERTY(bool isValid MEMBER isValid)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Frequency of the channel, in 10 kHz increments */
+    uint16_t frequency;
+
+    /* Received signal strength, in dBµV */
+    uint8_t rssi;
+
+    /* Signal-to-noise ratio, in dB */
+    uint8_t snr;
+
+    /* Multipath indicator, between 0 and 100 */
+    uint8_t multipath;
+
+    /* When set, the channel is considered a valid station */
+    bool isValid;
+} ScanRecord_t;
+
+/* Number of scan records that fit into a single report */
+#define SCAN_RECORDS_PER_REPORT ((MAX_PAYLOAD_SIZE - 4) / sizeof(ScanRecord_t))
+
+typedef struct _ScanResultsReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t sequence MEMBER sequence)
+    Q_PROPERTY(bool isFinal MEMBER isFinal)
+    Q_PROPERTY(QVariantList records READ GetRecords)
+
+  public:
+    QVariantList GetRecords() const
+    {
+        QVariantList list;
+
+        for (uint8_t i = 0; i < count && i < SCAN_RECORDS_PER_REPORT; i++)
+        {
+            list.append(QVariant::fromValue(records[i]));
+        }
+
+        return list;
+    }
+#endif /* __cplusplus */
+
+    /* Running number of the batch within the scan, starting from zero */
+    uint16_t sequence;
+
+    /* Number of records in the batch */
+    uint8_t count;
+
+    /* When set, this is the last batch of the scan */
+    bool isFinal;
+
+    /* Scan records, in the order the channels were measured */
+    ScanRecord_t records[SCAN_RECORDS_PER_REPORT];
+} ScanResultsReport_t;
+
+static_assert(sizeof(ScanResultsReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _ScanSummaryReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t bottom MEMBER bottom)
+    Q_PROPERTY(uint16_t top MEMBER top)
+    Q_PROPERTY(uint16_t spacing MEMBER spacing)
+    Q_PROPERTY(uint16_t channelCount MEMBER channelCount)
+    Q_PROPERTY(uint16_t validCount MEMBER validCount)
+    Q_PROPERTY(bool isStopped MEMBER isStopped)
+    Q_PROPERTY(uint32_t duration MEMBER duration)
+    Q_PROPERTY(uint16_t channelsPerSecond MEMBER channelsPerSecond)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Bottom and top of the scanned band, and the channel spacing, in 10 kHz increments */
+    uint16_t bottom;
+    uint16_t top;
+    uint16_t spacing;
+
+    /* Number of channels measured */
+    uint16_t channelCount;
+
+    /* Number of channels that were valid stations */
+    uint16_t validCount;
+
+    /* When set, the scan was stopped before reaching the top of the band */
+    bool isStopped;
+
+    /* Duration of the scan, in ms */
+    uint32_t duration;
+
+    /* Throughput of the scan, in hundredths of a channel per second */
+    uint16_t channelsPerSecond;
+} ScanSummaryReport_t;
+
+static_assert(sizeof(ScanSummaryReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _SeekProgressReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t frequency MEMBER frequency)
+    Q_PROPERTY(uint8_t rssi MEMBER rssi)
+    Q_PROPERTY(uint8_t snr MEMBER snr)
+    Q_PROPERTY(bool bandLimit MEMBER bandLimit)
+    Q_PROPERTY(bool isCancelled MEMBER isCancelled)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Frequency the seek has currently reached, in 10 kHz increments */
+    uint16_t frequency;
+
+    /* Received signal strength at the current frequency, in dBµV */
+    uint8_t rssi;
+
+    /* Signal-to-noise ratio at the current frequency, in dB */
+    uint8_t snr;
+
+    /* When set, the seek has hit the band limit */
+    bool bandLimit;
+
+    /* When set, this is the final progress report of a cancelled seek */
+    bool isCancelled;
+} SeekProgressReport_t;
+
+static_assert(sizeof(SeekProgressReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _TuneStatusReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t frequency MEMBER frequency)
+    Q_PROPERTY(uint8_t rssi MEMBER rssi)
+    Q_PROPERTY(uint8_t snr MEMBER snr)
+    Q_PROPERTY(uint8_t multipath MEMBER multipath)
+    Q_PROPERTY(uint8_t antennaCapacitor MEMBER antennaCapacitor)
+    Q_PROPERTY(bool validChannel MEMBER validChannel)
+    Q_PROPERTY(bool AFCRail MEMBER AFCRail)
+    Q_PROPERTY(bool bandLimit MEMBER bandLimit)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Frequency the radio is tuned to, in 10 kHz increments */
+    uint16_t frequency;
+
+    /* Received signal strength, in dBµV */
+    uint8_t rssi;
+
+    /* Signal-to-noise ratio, in dB */
+    uint8_t snr;
+
+    /* Multipath indicator, in % */
+    uint8_t multipath;
+
+    /* Antenna tuning capacitor value in use */
+    uint8_t antennaCapacitor;
+
+    /* When set, the channel is considered valid according to the seek/tune properties */
+    bool validChannel;
+
+    /* Set if the AFC rails */
+    bool AFCRail;
+
+    /* When set, a seek has hit the band limit */
+    bool bandLimit;
+} TuneStatusReport_t;
+
+static_assert(sizeof(TuneStatusReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _AlternativeFrequencyReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(bool isEnabled MEMBER isEnabled)
+    Q_PROPERTY(uint16_t programmeIdentification MEMBER programmeIdentification)
+    Q_PROPERTY(QVariantList frequencies READ GetFrequencies)
+    Q_PROPERTY(uint16_t checkCount MEMBER checkCount)
+    Q_PROPERTY(uint16_t switchCount MEMBER switchCount)
+    Q_PROPERTY(uint32_t muteTime MEMBER muteTime)
+
+  public:
+    QVariantList GetFrequencies() const
+    {
+        QVariantList list;
+
+        for (uint8_t i = 0; i < count && i < ALTERNATIVE_FREQUENCY_COUNT; i++)
+        {
+            list.append(frequencies[i]);
+        }
+
+        return list;
+    }
+#endif /* __cplusplus */
+
+    /* When set, the device switches to a better alternative frequency when the signal degrades */
+    bool isEnabled;
+
+    /* Number of alternative frequencies in the list */
+    uint8_t count;
+
+    /* Programme Identification (PI) code of the station the list belongs to */
+    uint16_t programmeIdentification;
+
+    /* Alternative frequencies, in 10 kHz increments */
+    uint16_t frequencies[ALTERNATIVE_FREQUENCY_COUNT];
+
+    /* Number of times the alternative frequencies have been checked, and switched to */
+    uint16_t checkCount;
+    uint16_t switchCount;
+
+    /* Total time the audio has been muted for the checks, in ms */
+    uint32_t muteTime;
+} AlternativeFrequencyReport_t;
+
+static_assert(sizeof(AlternativeFrequencyReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _PropertyValue_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t property MEMBER property)
+    Q_PROPERTY(uint16_t value MEMBER value)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Identifier of the property */
+    uint16_t property;
+
+    /* Value of the property */
+    uint16_t value;
+} PropertyValue_t;
+
+typedef struct _PropertyBulkReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint8_t sequence MEMBER sequence)
+    Q_PROPERTY(bool isSet MEMBER isSet)
+    Q_PROPERTY(uint8_t failedCount MEMBER failedCount)
+    Q_PROPERTY(uint32_t failedMask MEMBER failedMask)
+    Q_PROPERTY(QVariantList properties READ GetProperties)
+
+  public:
+    QVariantList GetProperties() const
+    {
+        QVariantList list;
+
+        for (uint8_t i = 0; i < count && i < PROPERTY_BULK_COUNT; i++)
+        {
+            list.append(QVariant::fromValue(properties[i]));
+        }
+
+        return list;
+    }
+#endif /* __cplusplus */
+
+    /* Sequence number of the request these are the results of */
+    uint8_t sequence;
+
+    /* Number of properties in the results */
+    uint8_t count;
+
+    /* When set, these are the results of a bulk set; otherwise of a bulk get */
+    bool isSet;
+
+    /* Number of properties that could not be set or read */
+    uint8_t failedCount;
+
+    /* Bit mask of the properties that could not be set or read, indexed by their position */
+    uint32_t failedMask;
+
+    /* Properties and their values; a set reports the values the radio will hold */
+    PropertyValue_t properties[PROPERTY_BULK_COUNT];
+} PropertyBulkReport_t;
+
+static_assert(sizeof(PropertyBulkReport_t) <= MAX_PAYLOAD_SIZE);
+static_assert(PROPERTY_BULK_COUNT <= 32);
+
+typedef struct _InterruptStatisticsReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t wakeups MEMBER wakeups)
+    Q_PROPERTY(uint16_t spuriousWakeups MEMBER spuriousWakeups)
+    Q_PROPERTY(QList<int> counts READ GetCounts)
+    Q_PROPERTY(QList<int> spuriousCounts READ GetSpuriousCounts)
+    Q_PROPERTY(QList<int> averageLatency READ GetAverageLatency)
+    Q_PROPERTY(QList<int> maximumLatency READ GetMaximumLatency)
+
+  public:
+    QList<int> GetCounts() const
+    {
+        return QList<int>(std::begin(counts), std::end(counts));
+    }
+
+    QList<int> GetSpuriousCounts() const
+    {
+        return QList<int>(std::begin(spuriousCounts), std::end(spuriousCounts));
+    }
+
+    QList<int> GetAverageLatency() const
+    {
+        return QList<int>(std::begin(averageLatency), std::end(averageLatency));
+    }
+
+    QList<int> GetMaximumLatency() const
+    {
+        return QList<int>(std::begin(maximumLatency), std::end(maximumLatency));
+    }
+#endif /* __cplusplus */
+
+    /* Number of times the status byte was read after an interrupt since the previous report */
+    uint16_t wakeups;
+
+    /* Number of those reads that found no newly raised source */
+    uint16_t spuriousWakeups;
+
+    /* The following are per source, in the order CTS, STC, RDS, RSQ and ERR, since the previous report */
+
+    /* Number of times the source was raised */
+    uint16_t counts[INTERRUPT_SOURCE_COUNT];
+
+    /* Number of times the source was raised while nothing was waiting for it */
+    uint16_t spuriousCounts[INTERRUPT_SOURCE_COUNT];
+
+    /* Average and longest time from the interrupt edge to servicing the source, in µs */
+    uint16_t averageLatency[INTERRUPT_SOURCE_COUNT];
+    uint16_t maximumLatency[INTERRUPT_SOURCE_COUNT];
+} InterruptStatisticsReport_t;
+
+static_assert(sizeof(InterruptStatisticsReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _CommandLatency_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint8_t opCode MEMBER opCode)
+    Q_PROPERTY(uint16_t count MEMBER count)
+    Q_PROPERTY(uint16_t minimum MEMBER minimum)
+    Q_PROPERTY(uint16_t average MEMBER average)
+    Q_PROPERTY(uint16_t maximum MEMBER maximum)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Opcode of the command */
+    uint8_t opCode;
+
+    /* Number of commands completed during the window */
+    uint16_t count;
+
+    /* Shortest, average and longest time from sending the command to its completion, in µs; seeks,
+     * which may run for seconds, saturate at 65535 */
+    uint16_t minimum;
+    uint16_t average;
+    uint16_t maximum;
+} CommandLatency_t;
+
+typedef struct _TelemetryReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint32_t loopRate MEMBER loopRate)
+    Q_PROPERTY(uint32_t maximumLoopPeriod MEMBER maximumLoopPeriod)
+    Q_PROPERTY(uint16_t window MEMBER window)
+    Q_PROPERTY(uint8_t commandQueueHighWater MEMBER commandQueueHighWater)
+    Q_PROPERTY(uint8_t reportQueueHighWater MEMBER reportQueueHighWater)
+    Q_PROPERTY(uint16_t droppedCommands MEMBER droppedCommands)
+    Q_PROPERTY(uint16_t droppedReports MEMBER droppedReports)
+    Q_PROPERTY(uint8_t i2cBusy MEMBER i2cBusy)
+    Q_PROPERTY(QVariantList commands READ GetCommands)
+
+  public:
+    QVariantList GetCommands() const
+    {
+        QVariantList list;
+
+        for (uint8_t i = 0; i < commandCount && i < TELEMETRY_COMMAND_COUNT; i++)
+        {
+            list.append(QVariant::fromValue(commands[i]));
+        }
+
+        return list;
+    }
+#endif /* __cplusplus */
+
+    /* Main loop iterations per second during the window */
+    uint32_t loopRate;
+
+    /* Longest main loop iteration during the window, in µs */
+    uint32_t maximumLoopPeriod;
+
+    /* Length of the window, which runs from the previous telemetry report to this one, in ms */
+    uint16_t window;
+
+    /* Highest number of commands and reports in their queues during the window */
+    uint8_t commandQueueHighWater;
+    uint8_t reportQueueHighWater;
+
+    /* Total number of commands and reports that did not fit into their queues */
+    uint16_t droppedCommands;
+    uint16_t droppedReports;
+
+    /* Share of the window the I2C bus was transferring, in percent */
+    uint8_t i2cBusy;
+
+    /* Number of commands in the latency list */
+    uint8_t commandCount;
+
+    /* Latency of each command sent during the window, in the order the commands were first sent */
+    CommandLatency_t commands[TELEMETRY_COMMAND_COUNT];
+} TelemetryReport_t;
+
+static_assert(sizeof(TelemetryReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _MemoryUsageReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint16_t ramSize MEMBER ramSize)
+    Q_PROPERTY(uint16_t staticSize MEMBER staticSize)
+    Q_PROPERTY(uint16_t stackReserve MEMBER stackReserve)
+    Q_PROPERTY(uint16_t stackHighWater MEMBER stackHighWater)
+    Q_PROPERTY(uint16_t unusedSize MEMBER unusedSize)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Size of the RAM, in bytes */
+    uint16_t ramSize;
+
+    /* Size of the initialized and zeroed static data, in bytes */
+    uint16_t staticSize;
+
+    /* Stack size reserved by the linker script, in bytes */
+    uint16_t stackReserve;
+
+    /* Deepest stack use since reset, in bytes; interrupts included */
+    uint16_t stackHighWater;
+
+    /* RAM between the static data and the deepest stack use that has never been touched, in bytes */
+    uint16_t unusedSize;
+} MemoryUsageReport_t;
+
+static_assert(sizeof(MemoryUsageReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _FaultReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(FaultSource_t source MEMBER source)
+    Q_PROPERTY(uint8_t commandOpCode MEMBER commandOpCode)
+    Q_PROPERTY(uint8_t commandState MEMBER commandState)
+    Q_PROPERTY(RadioState_t radioState MEMBER radioState)
+    Q_PROPERTY(uint32_t programCounter MEMBER programCounter)
+    Q_PROPERTY(uint32_t linkRegister MEMBER linkRegister)
+    Q_PROPERTY(uint32_t programStatus MEMBER programStatus)
+    Q_PROPERTY(uint16_t faultCount MEMBER faultCount)
+    Q_PROPERTY(SupervisedSubsystem_t subsystem MEMBER subsystem)
+
+  public:
+#endif /* __cplusplus */
+
+    /* What brought the previous run down */
+    FaultSource_t source;
+
+    /* Opcode and state of the command at the front of the queue at the time; zero if the queue was empty */
+    uint8_t commandOpCode;
+    uint8_t commandState;
+
+    /* State of the radio at the time */
+    RadioState_t radioState;
+
+    /* Address of the faulting instruction; for the error handler, the address it returns to */
+    uint32_t programCounter;
+
+    /* Link register and program status register stacked by the fault; zero for the error handler and the watchdog */
+    uint32_t linkRegister;
+    uint32_t programStatus;
+
+    /* Number of fault and watchdog resets since power-on */
+    uint16_t faultCount;
+
+    /* Subsystem that stopped making progress; only valid when the supervisor reset the device */
+    SupervisedSubsystem_t subsystem;
+} FaultReport_t;
+
+static_assert(sizeof(FaultReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _SubsystemRestartReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(SupervisedSubsystem_t subsystem MEMBER subsystem)
+    Q_PROPERTY(uint8_t commandOpCode MEMBER commandOpCode)
+    Q_PROPERTY(uint8_t commandState MEMBER commandState)
+    Q_PROPERTY(uint16_t restartCount MEMBER restartCount)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Subsystem that was restarted */
+    SupervisedSubsystem_t subsystem;
+
+    /* Opcode and state of the command at the front of the queue before the restart; zero if the queue was empty */
+    uint8_t commandOpCode;
+    uint8_t commandState;
+
+    /* Number of times the subsystem has been restarted since reset */
+    uint16_t restartCount;
+} SubsystemRestartReport_t;
+
+static_assert(sizeof(SubsystemRestartReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _PassthroughResponseReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint32_t duration MEMBER duration)
+    Q_PROPERTY(uint8_t correlationId MEMBER correlationId)
+    Q_PROPERTY(uint8_t opCode MEMBER opCode)
+    Q_PROPERTY(PassthroughResult_t result MEMBER result)
+    Q_PROPERTY(QVariantList response READ GetResponse)
+
+  public:
+    QVariantList GetResponse() const
+    {
+        QVariantList list;
+
+        for (uint8_t i = 0; i < responseLength && i < sizeof(response); i++)
+        {
+            list.append(response[i]);
+        }
+
+        return list;
+    }
+#endif /* __cplusplus */
+
+    /* Time from sending the command to its completion, in µs */
+    uint32_t duration;
+
+    /* Correlation identifier and opcode of the request */
+    uint8_t correlationId;
+    uint8_t opCode;
+
+    /* Whether the command was sent */
+    PassthroughResult_t result;
+
+    /* Response of the command, starting with the status byte; without a response to read, just the status byte */
+    uint8_t responseLength;
+    uint8_t response[16];
+} PassthroughResponseReport_t;
+
+static_assert(sizeof(PassthroughResponseReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _MacroCompletionReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint32_t duration MEMBER duration)
+    Q_PROPERTY(uint8_t macroId MEMBER macroId)
+    Q_PROPERTY(MacroResult_t result MEMBER result)
+    Q_PROPERTY(uint8_t commandCount MEMBER commandCount)
+    Q_PROPERTY(uint8_t completedCount MEMBER completedCount)
+    Q_PROPERTY(uint8_t failedIndex MEMBER failedIndex)
+    Q_PROPERTY(uint8_t failedStatus MEMBER failedStatus)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Time from queueing the macro to the completion of its last command, in µs */
+    uint32_t duration;
+
+    /* Identifier of the macro, and its outcome */
+    uint8_t macroId;
+    MacroResult_t result;
+
+    /* Number of commands in the macro, and of those that completed */
+    uint8_t commandCount;
+    uint8_t completedCount;
+
+    /* Index and status byte of the first command the radio rejected; MACRO_INDEX_NONE if there was none */
+    uint8_t failedIndex;
+    uint8_t failedStatus;
+} MacroCompletionReport_t;
+
+static_assert(sizeof(MacroCompletionReport_t) <= MAX_PAYLOAD_SIZE);
+
+typedef struct _AntennaCapacitorBenchmarkReport_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint8_t presetCount MEMBER presetCount)
+    Q_PROPERTY(uint32_t automaticAverage MEMBER automaticAverage)
+    Q_PROPERTY(uint32_t automaticMaximum MEMBER automaticMaximum)
+    Q_PROPERTY(uint32_t cachedAverage MEMBER cachedAverage)
+    Q_PROPERTY(uint32_t cachedMaximum MEMBER cachedMaximum)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Number of presets tuned to in each pass */
+    uint8_t presetCount;
+
+    /* Average and maximum tune times when the radio chooses the antenna tuning capacitor, in µs */
+    uint32_t automaticAverage;
+    uint32_t automaticMaximum;
+
+    /* Average and maximum tune times when the antenna tuning capacitor is taken from the cache, in µs */
+    uint32_t cachedAverage;
+    uint32_t cachedMaximum;
+} AntennaCapacitorBenchmarkReport_t;
+
+static_assert(sizeof(AntennaCapacitorBenchmarkReport_t) <= MAX_PAYLOAD_SIZE);
 
 typedef struct _TuneFreqRequest_t
 {
@@ -293,6 +1336,170 @@ typedef struct _SeekStartRequest_t
 
 static_assert(sizeof(SeekStartRequest_t) <= MAX_STRUCT_SIZE);
 
+typedef struct _AudioLevelWindowRequest_t
+{
+    /* Length of the metering window, in ms; clamped to 10...10000, and rounded to the nearest power of two frames */
+    uint16_t window;
+} AudioLevelWindowRequest_t;
+
+static_assert(sizeof(AudioLevelWindowRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _PresetStoreRequest_t
+{
+    /* Slot of the preset, between 0 and PRESET_COUNT - 1 */
+    uint8_t index;
+
+    /* Frequency to store, in 10 kHz increments; zero stores the current station along with its RDS
+     * identity and antenna tuning capacitor value */
+    uint16_t frequency;
+} PresetStoreRequest_t;
+
+static_assert(sizeof(PresetStoreRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _PresetRecallRequest_t
+{
+    /* Slot of the preset, between 0 and PRESET_COUNT - 1 */
+    uint8_t index;
+} PresetRecallRequest_t;
+
+static_assert(sizeof(PresetRecallRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _AGCOverrideRequest_t
+{
+    /* When set, the RF AGC is disabled and the LNA gain index below is used; otherwise the AGC is restored */
+    bool isAGCDisabled;
+
+    /* LNA gain index, between 0 (minimum attenuation) and 26 (maximum attenuation) */
+    uint8_t lnaGainIndex;
+} AGCOverrideRequest_t;
+
+static_assert(sizeof(AGCOverrideRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _PropertyBulkRequest_t
+{
+    /* Sequence number chosen by the host, and echoed in the results */
+    uint8_t sequence;
+
+    /* Number of properties in the request */
+    uint8_t count;
+
+    /* Properties and their values; the values are ignored by a bulk get */
+    PropertyValue_t properties[PROPERTY_BULK_COUNT];
+} PropertyBulkRequest_t;
+
+static_assert(sizeof(PropertyBulkRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _AlternativeFrequencyConfigRequest_t
+{
+    /* When set, the device switches to a better alternative frequency when the signal degrades */
+    bool isEnabled;
+
+    /* The alternative frequencies are checked when the RSSI, in dBµV, or the SNR, in dB, stays below these */
+    uint8_t rssiThreshold;
+    uint8_t snrThreshold;
+
+    /* How much stronger an alternative frequency must be to be switched to, in dB */
+    uint8_t minimumGain;
+} AlternativeFrequencyConfigRequest_t;
+
+static_assert(sizeof(AlternativeFrequencyConfigRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _TelemetryRequest_t
+{
+    /* Interval of the periodic telemetry reports, in ms; zero stops them. A telemetry report and a memory usage
+     * report are also sent right away */
+    uint16_t interval;
+} TelemetryRequest_t;
+
+static_assert(sizeof(TelemetryRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _RadioStatusHeartbeatRequest_t
+{
+    /* Interval of the radio status reports sent when nothing has changed, in ms; zero sends them only on a change of
+     * state, frequency, volume or mute. A radio status report is also sent right away */
+    uint16_t interval;
+} RadioStatusHeartbeatRequest_t;
+
+static_assert(sizeof(RadioStatusHeartbeatRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _PassthroughRequest_t
+{
+    /* Identifies the request in its response report; zero is reserved for the commands of the firmware */
+    uint8_t correlationId;
+
+    /* Opcode of the command, and the number of argument bytes that follow it, up to seven */
+    uint8_t opCode;
+    uint8_t argLength;
+    uint8_t args[7];
+
+    /* Number of response bytes to read, including the status byte, up to 16; zero reads none */
+    uint8_t responseLength;
+} PassthroughRequest_t;
+
+static_assert(sizeof(PassthroughRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _MacroRecord_t
+{
+    /* Opcode of the command, and the number of argument bytes that follow it, up to seven */
+    uint8_t opCode;
+    uint8_t argLength;
+    uint8_t args[7];
+} MacroRecord_t;
+
+typedef struct _MacroStoreRequest_t
+{
+    /* Slot to store the macro in, below MACRO_SLOT_COUNT */
+    uint8_t macroId;
+
+    /* Commands of the macro, in the order they are sent; a count of zero clears the slot */
+    uint8_t count;
+    MacroRecord_t records[MACRO_RECORD_COUNT];
+} MacroStoreRequest_t;
+
+static_assert(sizeof(MacroStoreRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _MacroRunRequest_t
+{
+    /* Slot of a stored macro, or the identifier of a built-in one */
+    uint8_t macroId;
+} MacroRunRequest_t;
+
+static_assert(sizeof(MacroRunRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _SnapshotSelectRequest_t
+{
+    /* Identifier of the report the feature report returns a snapshot of, until another one is selected */
+    uint8_t identifier;
+} SnapshotSelectRequest_t;
+
+static_assert(sizeof(SnapshotSelectRequest_t) <= MAX_STRUCT_SIZE);
+
+typedef struct _ReportEnvelope_t
+{
+#if defined __cplusplus
+    Q_GADGET
+
+    Q_PROPERTY(uint32_t timestamp MEMBER timestamp)
+    Q_PROPERTY(uint16_t frame MEMBER frame)
+    Q_PROPERTY(uint8_t sequence MEMBER sequence)
+
+  public:
+#endif /* __cplusplus */
+
+    /* Device time at which the report was generated, in µs; wraps around every 71 minutes */
+    uint32_t timestamp;
+
+    /* USB frame number at the time, from the latest start-of-frame; wraps around every 2048 ms */
+    uint16_t frame;
+
+    /* Running number of the report; a gap means reports were lost, whether the queue was full or the host missed them */
+    uint8_t sequence;
+} ReportEnvelope_t;
+
+/* Only the fields are sent, without the padding at the end */
+static_assert(offsetof(ReportEnvelope_t, sequence) + sizeof(uint8_t) == REPORT_ENVELOPE_SIZE);
+static_assert(REPORT_ENVELOPE_OFFSET + REPORT_ENVELOPE_SIZE <= MAX_STRUCT_SIZE);
+
 typedef struct _Report_t
 {
     /* Identifier of the report */
@@ -306,8 +1513,29 @@ typedef struct _Report_t
         RSQStatusResponse_t rsqStatus;
         RDSProgrammeServiceReport_t programmeService;
         RDSRadioTextReport_t radioText;
+        AudioStatisticsReport_t audioStatistics;
+        AudioLevelReport_t audioLevels;
+        BootMilestonesReport_t bootMilestones;
+        PresetListReport_t presetList;
+        ScanResultsReport_t scanResults;
+        ScanSummaryReport_t scanSummary;
+        SeekProgressReport_t seekProgress;
+        TuneStatusReport_t tuneStatus;
+        AlternativeFrequencyReport_t alternativeFrequency;
+        PropertyBulkReport_t propertyBulk;
+        InterruptStatisticsReport_t interruptStatistics;
+        TelemetryReport_t telemetry;
+        MemoryUsageReport_t memoryUsage;
+        FaultReport_t fault;
+        SubsystemRestartReport_t subsystemRestart;
+        PassthroughResponseReport_t passthroughResponse;
+        MacroCompletionReport_t macroCompletion;
+        AntennaCapacitorBenchmarkReport_t antennaCapacitorBenchmark;
         TuneFreqRequest_t tuneFreqRequest;
         SeekStartRequest_t seekStartRequest;
+        AudioLevelWindowRequest_t audioLevelWindowRequest;
+        PresetStoreRequest_t presetStoreRequest;
+        PresetRecallRequest_t presetRecallRequest;
 
         // This ensures any "sizeof(bytes)" will return the proper size
         uint8_t raw[MAX_STRUCT_SIZE];
@@ -0,0 +1,518 @@
+/**
+ ******************************************************************************
+ * @file    af.c
+ * @brief   Implements the following of the RDS alternative frequencies (AF);
+ *          when the signal degrades, the alternative frequencies of the
+ *          station are checked with the audio muted, and the radio switches
+ *          to one that is stronger and carries the same programme
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "af.h"
+#include "commands.h"
+#include "main.h"
+#include "properties.h"
+#include "rds.h"
+#include "scan.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef enum _AlternativeFrequencyState_t : uint8_t
+{
+    /* Monitoring the signal quality of the current station */
+    AF_STATE_IDLE = 0x00,
+
+    /* Waiting for the tune to an alternative frequency to complete */
+    AF_STATE_TUNING = 0x01,
+
+    /* Waiting for the PI code of the station on the alternative frequency */
+    AF_STATE_VERIFYING = 0x02,
+
+    /* The alternative frequency was not stronger; the next one is checked */
+    AF_STATE_REJECTED = 0x03,
+} AlternativeFrequencyState_t;
+
+typedef struct _AlternativeFrequencies_t
+{
+    /* Current state of the following */
+    AlternativeFrequencyState_t state;
+
+    /* Configuration set by the host */
+    AlternativeFrequencyConfigRequest_t config;
+
+    /* Programme Identification (PI) code of the station the list belongs to */
+    uint16_t programmeIdentification;
+
+    /* Number of alternative frequencies in the list */
+    uint8_t count;
+
+    /* Alternative frequencies as RDS codes; the frequency is 87.5 MHz + code * 100 kHz */
+    uint8_t codes[ALTERNATIVE_FREQUENCY_COUNT];
+
+    /* Number of consecutive RSQ readings below the thresholds */
+    uint8_t degradedCount;
+
+    /* Signal quality of the current station when the check was started */
+    uint8_t homeRssi;
+    uint8_t homeSnr;
+
+    /* Frequency of the current station when the check was started */
+    uint16_t homeFrequency;
+
+    /* Mute status to restore once the check has finished */
+    bool wasMuted;
+
+    /* Index of the list entry checked first on the next check, so every entry gets its turn */
+    uint8_t firstCandidate;
+
+    /* Number of alternative frequencies checked on the current check */
+    uint8_t candidateCount;
+
+    /* Frequency of the alternative frequency being checked; zero until the first one has been tuned */
+    uint16_t candidateFrequency;
+
+    /* Set when the PI code has been received on the alternative frequency */
+    bool isVerified;
+
+    /* Tick at which the current state times out, or the next check is allowed */
+    uint32_t deadlineTick;
+
+    /* Tick at which the audio was muted for the current check */
+    uint32_t muteStartTick;
+
+    /* Set when the list or the statistics have changed since the last report */
+    bool isReportPending;
+
+    /* Statistics reported to the host */
+    uint16_t checkCount;
+    uint16_t switchCount;
+    uint32_t muteTime;
+} AlternativeFrequencies_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+// Number of consecutive degraded RSQ readings that start a check; the readings are a second apart
+#define AF_DEGRADED_READINGS 2
+
+// Maximum number of alternative frequencies checked at once, which bounds the time the audio is muted
+#define AF_MAX_CANDIDATES_PER_CHECK 3
+
+// Time the PI code is waited for on an alternative frequency, in ms
+#define AF_VERIFY_WINDOW 300
+
+// Minimum time between two checks, in ms
+#define AF_CHECK_INTERVAL 10000
+
+// RDS codes of the alternative frequencies; other codes are fillers or list headers
+#define AF_CODE_FIRST_FREQUENCY 1
+#define AF_CODE_LAST_FREQUENCY 204
+#define AF_CODE_LF_MF_FOLLOWS 250
+
+/* Private macros ------------------------------------------------------------*/
+#define AF_CODE_TO_FREQUENCY(code) ((uint16_t)(8750 + (code) * 10))
+
+/* Private variables ---------------------------------------------------------*/
+AlternativeFrequencies_t alternativeFrequencies = {
+    .state = AF_STATE_IDLE,
+    .config = {.isEnabled = false, .rssiThreshold = 20, .snrThreshold = 8, .minimumGain = 6},
+};
+
+/* Private function prototypes -----------------------------------------------*/
+void AddAlternativeFrequency(uint8_t code);
+bool StartAlternativeFrequencyCheck(RadioDevice_t *device);
+bool CheckNextAlternativeFrequency(RadioDevice_t *device);
+void FinishAlternativeFrequencyCheck(RadioDevice_t *device, bool isSwitched);
+bool ReportAlternativeFrequencies(RadioDevice_t *device);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Configures the following of the alternative frequencies
+ * @param  config Pointer to the configuration
+ */
+void ConfigureAlternativeFrequencies(const AlternativeFrequencyConfigRequest_t *config)
+{
+    alternativeFrequencies.config = *config;
+    alternativeFrequencies.degradedCount = 0;
+    alternativeFrequencies.isReportPending = true;
+}
+
+/**
+ * @brief  Collects the alternative frequencies from the RDS group 0A of the
+ *         current station
+ * @param  blockA Block A of the group, which holds the PI code
+ * @param  blockB Block B of the group, which holds the group type
+ * @param  blockC Block C of the group, which holds two AF codes in group 0A
+ * @param  blockAErrors Errors in Block A
+ * @param  blockBErrors Errors in Block B
+ * @param  blockCErrors Errors in Block C
+ */
+void ProcessAlternativeFrequencyGroup(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint8_t blockAErrors,
+                                      uint8_t blockBErrors, uint8_t blockCErrors)
+{
+    if (blockAErrors != 0)
+    {
+        return;
+    }
+
+    // Every group carries the PI code, which verifies the station on an alternative frequency
+    if (alternativeFrequencies.state == AF_STATE_VERIFYING)
+    {
+        if (blockA == alternativeFrequencies.programmeIdentification)
+        {
+            alternativeFrequencies.isVerified = true;
+        }
+
+        return;
+    }
+
+    // The list is only collected from the current station
+    if (alternativeFrequencies.state != AF_STATE_IDLE)
+    {
+        return;
+    }
+
+    if (blockA != alternativeFrequencies.programmeIdentification)
+    {
+        // Tuned to a different station
+        alternativeFrequencies.programmeIdentification = blockA;
+        alternativeFrequencies.count = 0;
+        alternativeFrequencies.firstCandidate = 0;
+        alternativeFrequencies.isReportPending = true;
+    }
+
+    // Group type 0A; version B carries a PI code in block C instead
+    if (blockBErrors != 0 || blockCErrors != 0 || (blockB & 0xF800) != 0x0000)
+    {
+        return;
+    }
+
+    uint8_t first = (uint8_t)(blockC >> 8);
+    uint8_t second = (uint8_t)(blockC & 0xFF);
+
+    AddAlternativeFrequency(first);
+
+    // The code after the LF/MF marker is a long or medium wave frequency
+    if (first != AF_CODE_LF_MF_FOLLOWS)
+    {
+        AddAlternativeFrequency(second);
+    }
+}
+
+/**
+ * @brief  Monitors the signal quality of the current station from the
+ *         response of the "FM RSQ Status" command
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ */
+void ProcessAlternativeFrequencyRSQ(RadioDevice_t *device, Command_t *command)
+{
+    (void)device;
+
+    if (!alternativeFrequencies.config.isEnabled || alternativeFrequencies.state != AF_STATE_IDLE)
+    {
+        return;
+    }
+
+    uint8_t rssi = command->response[4];
+    uint8_t snr = command->response[5];
+
+    if (rssi < alternativeFrequencies.config.rssiThreshold || snr < alternativeFrequencies.config.snrThreshold)
+    {
+        if (alternativeFrequencies.degradedCount < AF_DEGRADED_READINGS)
+        {
+            alternativeFrequencies.degradedCount++;
+        }
+    }
+    else
+    {
+        alternativeFrequencies.degradedCount = 0;
+    }
+
+    alternativeFrequencies.homeRssi = rssi;
+    alternativeFrequencies.homeSnr = snr;
+}
+
+/**
+ * @brief  Records the signal quality of an alternative frequency from the
+ *         response of the "Get Tune Status" command
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the response was recorded by the check; false otherwise
+ */
+bool ProcessAlternativeFrequencyTuneStatus(RadioDevice_t *device, Command_t *command)
+{
+    (void)device;
+
+    if (alternativeFrequencies.state != AF_STATE_TUNING)
+    {
+        return false;
+    }
+
+    // Only the tune to the candidate is its result; any other tune belongs to someone else
+    uint16_t frequency = (uint16_t)((command->response[2] << 8) | (command->response[3] << 0));
+
+    if (frequency != alternativeFrequencies.candidateFrequency)
+    {
+        return false;
+    }
+
+    bool isValid = command->response[1] & 0x01;
+    uint8_t rssi = command->response[4];
+    uint8_t snr = command->response[5];
+
+    if (isValid && rssi >= alternativeFrequencies.homeRssi + alternativeFrequencies.config.minimumGain &&
+        snr >= alternativeFrequencies.homeSnr)
+    {
+        // Stronger; switch to it once the PI code confirms it carries the same programme. The radio
+        // empties its RDS FIFO on tune, so the groups received from now on are from this frequency
+        alternativeFrequencies.isVerified = false;
+        alternativeFrequencies.deadlineTick = HAL_GetTick() + AF_VERIFY_WINDOW;
+        alternativeFrequencies.state = AF_STATE_VERIFYING;
+    }
+    else
+    {
+        // Not worth verifying; the next one is checked from the main loop
+        alternativeFrequencies.state = AF_STATE_REJECTED;
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Advances the following of the alternative frequencies; called from
+ *         the main loop
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a check is in progress; false otherwise
+ */
+bool ProcessAlternativeFrequencies(RadioDevice_t *device)
+{
+    if (alternativeFrequencies.state == AF_STATE_IDLE)
+    {
+        if (alternativeFrequencies.degradedCount >= AF_DEGRADED_READINGS &&
+            (int32_t)(HAL_GetTick() - alternativeFrequencies.deadlineTick) >= 0)
+        {
+            StartAlternativeFrequencyCheck(device);
+        }
+    }
+    else if (alternativeFrequencies.state == AF_STATE_VERIFYING)
+    {
+        if (alternativeFrequencies.isVerified)
+        {
+            FinishAlternativeFrequencyCheck(device, true);
+        }
+        else if ((int32_t)(HAL_GetTick() - alternativeFrequencies.deadlineTick) >= 0)
+        {
+            CheckNextAlternativeFrequency(device);
+        }
+    }
+    else if (alternativeFrequencies.state == AF_STATE_REJECTED)
+    {
+        CheckNextAlternativeFrequency(device);
+    }
+
+    if (alternativeFrequencies.isReportPending)
+    {
+        alternativeFrequencies.isReportPending = !ReportAlternativeFrequencies(device);
+    }
+
+    return alternativeFrequencies.state != AF_STATE_IDLE;
+}
+
+/**
+ * @brief  Abandons the check in progress without returning to the current
+ *         station, and restores the audio; invoked when the host tunes, seeks
+ *         or recalls a preset, which takes the radio elsewhere
+ * @param  device Pointer to the radio device structure
+ */
+void AbortAlternativeFrequencyCheck(RadioDevice_t *device)
+{
+    if (alternativeFrequencies.state == AF_STATE_IDLE)
+    {
+        return;
+    }
+
+    // The frequency the host asked for replaces the one the check would have returned to
+    alternativeFrequencies.homeFrequency = 0;
+
+    FinishAlternativeFrequencyCheck(device, false);
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Adds an alternative frequency to the list, unless it is there already
+ * @param  code RDS code of the alternative frequency
+ */
+void AddAlternativeFrequency(uint8_t code)
+{
+    if (code < AF_CODE_FIRST_FREQUENCY || code > AF_CODE_LAST_FREQUENCY)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < alternativeFrequencies.count; i++)
+    {
+        if (alternativeFrequencies.codes[i] == code)
+        {
+            return;
+        }
+    }
+
+    if (alternativeFrequencies.count < ALTERNATIVE_FREQUENCY_COUNT)
+    {
+        alternativeFrequencies.codes[alternativeFrequencies.count++] = code;
+        alternativeFrequencies.isReportPending = true;
+    }
+}
+
+/**
+ * @brief  Mutes the audio and starts checking the alternative frequencies
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the check was started; false otherwise
+ */
+bool StartAlternativeFrequencyCheck(RadioDevice_t *device)
+{
+    alternativeFrequencies.degradedCount = 0;
+
+    // The PI code of the current station is needed to verify the alternative frequencies
+    if (alternativeFrequencies.count == 0 || alternativeFrequencies.programmeIdentification == 0 ||
+        RDSGetProgrammeIdentification() != alternativeFrequencies.programmeIdentification || IsScanning() ||
+        device->currentState < RADIOSTATE_TUNED_TO_STATION || device->currentFrequency == 0)
+    {
+        return false;
+    }
+
+    alternativeFrequencies.homeFrequency = device->currentFrequency;
+    alternativeFrequencies.wasMuted = device->isMuted;
+    alternativeFrequencies.candidateCount = 0;
+    alternativeFrequencies.candidateFrequency = 0;
+    alternativeFrequencies.muteStartTick = HAL_GetTick();
+    alternativeFrequencies.checkCount++;
+
+    if (!alternativeFrequencies.wasMuted)
+    {
+        SetMute(device, RX_HARD_MUTE_ARGS_BOTH);
+    }
+
+    return CheckNextAlternativeFrequency(device);
+}
+
+/**
+ * @brief  Tunes to the next alternative frequency of the check, or returns to
+ *         the current station when there are no more to check
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a tune to an alternative frequency was enqueued; false otherwise
+ */
+bool CheckNextAlternativeFrequency(RadioDevice_t *device)
+{
+    while (alternativeFrequencies.candidateCount < AF_MAX_CANDIDATES_PER_CHECK &&
+           alternativeFrequencies.candidateCount < alternativeFrequencies.count)
+    {
+        uint8_t index = alternativeFrequencies.firstCandidate % alternativeFrequencies.count;
+
+        alternativeFrequencies.firstCandidate = index + 1;
+        alternativeFrequencies.candidateCount++;
+
+        uint16_t frequency = AF_CODE_TO_FREQUENCY(alternativeFrequencies.codes[index]);
+
+        if (frequency == alternativeFrequencies.homeFrequency)
+        {
+            continue;
+        }
+
+        if (TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, frequency, 0))
+        {
+            alternativeFrequencies.candidateFrequency = frequency;
+            alternativeFrequencies.state = AF_STATE_TUNING;
+
+            return true;
+        }
+    }
+
+    FinishAlternativeFrequencyCheck(device, false);
+
+    return false;
+}
+
+/**
+ * @brief  Finishes the check, either staying on the verified alternative
+ *         frequency or returning to the current station, and restores the audio
+ * @param  device Pointer to the radio device structure
+ * @param  isSwitched True if the radio stays on the alternative frequency
+ */
+void FinishAlternativeFrequencyCheck(RadioDevice_t *device, bool isSwitched)
+{
+    // The current frequency stays on the station during the check, as the tune statuses of
+    // the candidates do not update it
+    if (isSwitched)
+    {
+        alternativeFrequencies.switchCount++;
+
+        // Reading the tune status again, now that the check is over, makes the alternative
+        // frequency the current station
+        TuneStatus(device, GET_TUNE_STATUS_ARGS_NONE);
+    }
+    else if (alternativeFrequencies.homeFrequency != 0 && alternativeFrequencies.candidateFrequency != 0)
+    {
+        TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, alternativeFrequencies.homeFrequency, 0);
+    }
+
+    if (!alternativeFrequencies.wasMuted)
+    {
+        SetMute(device, RX_HARD_MUTE_ARGS_NONE);
+    }
+
+    alternativeFrequencies.muteTime += HAL_GetTick() - alternativeFrequencies.muteStartTick;
+    alternativeFrequencies.deadlineTick = HAL_GetTick() + AF_CHECK_INTERVAL;
+    alternativeFrequencies.state = AF_STATE_IDLE;
+    alternativeFrequencies.isReportPending = true;
+}
+
+/**
+ * @brief  Enqueues the alternative frequencies and the statistics as a new report
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportAlternativeFrequencies(RadioDevice_t *device)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_AF_STATUS;
+
+    AlternativeFrequencyReport_t *status = &report.bytes.alternativeFrequency;
+
+    status->isEnabled = alternativeFrequencies.config.isEnabled;
+    status->count = alternativeFrequencies.count;
+    status->programmeIdentification = alternativeFrequencies.programmeIdentification;
+
+    for (uint8_t i = 0; i < alternativeFrequencies.count; i++)
+    {
+        status->frequencies[i] = AF_CODE_TO_FREQUENCY(alternativeFrequencies.codes[i]);
+    }
+
+    status->checkCount = alternativeFrequencies.checkCount;
+    status->switchCount = alternativeFrequencies.switchCount;
+    status->muteTime = alternativeFrequencies.muteTime;
+
+    return EnqueueReport(device, &report);
+}
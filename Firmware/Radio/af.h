@@ -0,0 +1,52 @@
+/**
+ ******************************************************************************
+ * @file    af.h
+ * @brief   Header for af.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __AF_H__
+#define __AF_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern void ConfigureAlternativeFrequencies(const AlternativeFrequencyConfigRequest_t *config);
+extern void ProcessAlternativeFrequencyGroup(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint8_t blockAErrors,
+                                             uint8_t blockBErrors, uint8_t blockCErrors);
+extern void ProcessAlternativeFrequencyRSQ(RadioDevice_t *device, Command_t *command);
+extern bool ProcessAlternativeFrequencyTuneStatus(RadioDevice_t *device, Command_t *command);
+extern bool ProcessAlternativeFrequencies(RadioDevice_t *device);
+extern void AbortAlternativeFrequencyCheck(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __AF_H__ */
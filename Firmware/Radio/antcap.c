@@ -0,0 +1,366 @@
+/**
+ ******************************************************************************
+ * @file    antcap.c
+ * @brief   Implements the cache of the antenna tuning capacitor values that
+ *          the radio has chosen for each channel, and a benchmark of the
+ *          tune times with and without the cache
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "antcap.h"
+#include "commands.h"
+#include "presets.h"
+#include "scan.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _AntennaCapacitorEntry_t
+{
+    /* Frequency of the channel, in 10 kHz increments; zero marks a free entry */
+    uint16_t frequency;
+
+    /* Antenna tuning capacitor value the radio chose for the channel */
+    uint8_t antennaCapacitor;
+
+    /* Value of the use counter when the entry was last used; the least recently used entry is replaced */
+    uint8_t lastUse;
+} AntennaCapacitorEntry_t;
+
+typedef enum _BenchmarkState_t : uint8_t
+{
+    /* No benchmark is in progress */
+    BENCHMARK_STATE_IDLE = 0x00,
+
+    /* Waiting for the tune to a preset to complete */
+    BENCHMARK_STATE_TUNING = 0x01,
+} BenchmarkState_t;
+
+typedef enum _BenchmarkPass_t : uint8_t
+{
+    /* The radio chooses the antenna tuning capacitor automatically */
+    BENCHMARK_PASS_AUTOMATIC = 0x00,
+
+    /* The antenna tuning capacitor is taken from the cache */
+    BENCHMARK_PASS_CACHED = 0x01,
+} BenchmarkPass_t;
+
+typedef struct _Benchmark_t
+{
+    /* Current state of the benchmark */
+    BenchmarkState_t state;
+
+    /* Current pass of the benchmark */
+    BenchmarkPass_t pass;
+
+    /* Slot of the preset being tuned to */
+    uint8_t presetIndex;
+
+    /* Frequency to return to once the benchmark has finished */
+    uint16_t resumeFrequency;
+
+    /* Sum of the tune times of each pass, in µs */
+    uint32_t total[2];
+
+    /* Results that are reported once both passes have finished */
+    AntennaCapacitorBenchmarkReport_t report;
+} Benchmark_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+// Number of channels in the cache; each entry takes four bytes of RAM
+#define ANTENNA_CAPACITOR_CACHE_SIZE 16
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+AntennaCapacitorEntry_t antennaCapacitorCache[ANTENNA_CAPACITOR_CACHE_SIZE] = {0};
+
+// Incremented on every use of the cache
+uint8_t antennaCapacitorUseCounter = 0;
+
+// Cleared during the automatic pass of the benchmark
+bool isAntennaCapacitorCacheEnabled = true;
+
+Benchmark_t benchmark = {.state = BENCHMARK_STATE_IDLE};
+
+/* Private function prototypes -----------------------------------------------*/
+bool StartBenchmarkTune(RadioDevice_t *device);
+bool FinishBenchmark(RadioDevice_t *device);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Looks up the antenna tuning capacitor value of the given channel
+ * @param  frequency Frequency of the channel, in 10 kHz increments
+ *
+ * @retval Cached antenna tuning capacitor value; zero if the channel is not
+ *         in the cache, which lets the radio choose the value automatically
+ */
+uint8_t LookupAntennaCapacitor(uint16_t frequency)
+{
+    if (!isAntennaCapacitorCacheEnabled || frequency == 0)
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < ANTENNA_CAPACITOR_CACHE_SIZE; i++)
+    {
+        if (antennaCapacitorCache[i].frequency == frequency)
+        {
+            antennaCapacitorCache[i].lastUse = ++antennaCapacitorUseCounter;
+
+            return antennaCapacitorCache[i].antennaCapacitor;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Stores the antenna tuning capacitor value of the given channel into
+ *         the cache, replacing the least recently used entry when it is full
+ * @param  frequency Frequency of the channel, in 10 kHz increments
+ * @param  antennaCapacitor Antenna tuning capacitor value, between 1 and 191
+ */
+void CacheAntennaCapacitor(uint16_t frequency, uint8_t antennaCapacitor)
+{
+    if (frequency == 0 || antennaCapacitor == 0 || antennaCapacitor > SI4705_ANTCAP_MAX_SETTING)
+    {
+        return;
+    }
+
+    AntennaCapacitorEntry_t *entry = &antennaCapacitorCache[0];
+
+    for (uint8_t i = 0; i < ANTENNA_CAPACITOR_CACHE_SIZE; i++)
+    {
+        AntennaCapacitorEntry_t *candidate = &antennaCapacitorCache[i];
+
+        if (candidate->frequency == frequency)
+        {
+            entry = candidate;
+            break;
+        }
+
+        // Free entries are used first; the age wraps around with the counter
+        if (entry->frequency != 0 &&
+            (candidate->frequency == 0 || (uint8_t)(antennaCapacitorUseCounter - candidate->lastUse) >
+                                              (uint8_t)(antennaCapacitorUseCounter - entry->lastUse)))
+        {
+            entry = candidate;
+        }
+    }
+
+    entry->frequency = frequency;
+    entry->antennaCapacitor = antennaCapacitor;
+    entry->lastUse = ++antennaCapacitorUseCounter;
+}
+
+/**
+ * @brief  Seeds the cache with the antenna tuning capacitor values stored
+ *         with the presets, so the presets tune fast right after a boot
+ */
+void SeedAntennaCapacitors(void)
+{
+    for (uint8_t i = 0; i < PRESET_COUNT; i++)
+    {
+        Preset_t preset;
+
+        if (ReadPreset(i, &preset))
+        {
+            CacheAntennaCapacitor(preset.frequency, preset.antennaCapacitor);
+        }
+    }
+}
+
+/**
+ * @brief  Starts a benchmark that tunes to every preset twice, first letting
+ *         the radio choose the antenna tuning capacitor and then using the
+ *         cache, and reports the tune times of both passes
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the benchmark was started; false otherwise
+ */
+bool StartAntennaCapacitorBenchmark(RadioDevice_t *device)
+{
+    if (device == NULL || benchmark.state != BENCHMARK_STATE_IDLE || IsScanning() ||
+        device->currentState == RADIOSTATE_POWERDOWN)
+    {
+        return false;
+    }
+
+    memset(&benchmark, 0, sizeof(Benchmark_t));
+
+    benchmark.pass = BENCHMARK_PASS_AUTOMATIC;
+    benchmark.resumeFrequency = device->currentFrequency;
+
+    if (!StartBenchmarkTune(device))
+    {
+        // There are no presets to tune to
+        return FinishBenchmark(device);
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Advances the benchmark; called from the main loop
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the benchmark is in progress; false otherwise
+ */
+bool ProcessAntennaCapacitorBenchmark(RadioDevice_t *device)
+{
+    if (benchmark.state == BENCHMARK_STATE_IDLE)
+    {
+        return false;
+    }
+
+    // The tune is complete once the commands it has scheduled have been sent too
+    if (device->commandQueue.count > 0)
+    {
+        return true;
+    }
+
+    AntennaCapacitorBenchmarkReport_t *report = &benchmark.report;
+
+    uint32_t *maximum = benchmark.pass == BENCHMARK_PASS_AUTOMATIC ? &report->automaticMaximum : &report->cachedMaximum;
+
+    benchmark.total[benchmark.pass] += device->lastTuneDuration;
+
+    if (device->lastTuneDuration > *maximum)
+    {
+        *maximum = device->lastTuneDuration;
+    }
+
+    benchmark.presetIndex++;
+
+    if (!StartBenchmarkTune(device))
+    {
+        if (benchmark.pass == BENCHMARK_PASS_CACHED)
+        {
+            FinishBenchmark(device);
+
+            return false;
+        }
+
+        // The automatic pass has also filled in the cache for the presets that were missing from it
+        benchmark.pass = BENCHMARK_PASS_CACHED;
+        benchmark.presetIndex = 0;
+
+        if (!StartBenchmarkTune(device))
+        {
+            FinishBenchmark(device);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Ends the benchmark right away without returning to the original
+ *         station, and reports it empty, like one without presets; invoked
+ *         when the host tunes, seeks, recalls a preset or starts a scan, which
+ *         takes the radio elsewhere, or when the command engine is restarted
+ * @param  device Pointer to the radio device structure
+ */
+void AbortAntennaCapacitorBenchmark(RadioDevice_t *device)
+{
+    if (benchmark.state == BENCHMARK_STATE_IDLE)
+    {
+        return;
+    }
+
+    // The tune times measured so far cover only a part of the presets
+    memset(&benchmark.report, 0, sizeof(AntennaCapacitorBenchmarkReport_t));
+
+    benchmark.resumeFrequency = 0;
+
+    FinishBenchmark(device);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Tunes to the next preset of the current pass
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a tune was enqueued; false if the pass has no more presets
+ */
+bool StartBenchmarkTune(RadioDevice_t *device)
+{
+    for (; benchmark.presetIndex < PRESET_COUNT; benchmark.presetIndex++)
+    {
+        Preset_t preset;
+
+        if (!ReadPreset(benchmark.presetIndex, &preset))
+        {
+            continue;
+        }
+
+        isAntennaCapacitorCacheEnabled = benchmark.pass == BENCHMARK_PASS_CACHED;
+
+        if (!TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, preset.frequency, 0))
+        {
+            return false;
+        }
+
+        if (benchmark.pass == BENCHMARK_PASS_AUTOMATIC)
+        {
+            benchmark.report.presetCount++;
+        }
+
+        benchmark.state = BENCHMARK_STATE_TUNING;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief  Reports the results of the benchmark, and returns to the station
+ *         that was tuned to before the benchmark
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool FinishBenchmark(RadioDevice_t *device)
+{
+    AntennaCapacitorBenchmarkReport_t *report = &benchmark.report;
+
+    if (report->presetCount > 0)
+    {
+        report->automaticAverage = benchmark.total[BENCHMARK_PASS_AUTOMATIC] / report->presetCount;
+        report->cachedAverage = benchmark.total[BENCHMARK_PASS_CACHED] / report->presetCount;
+    }
+
+    benchmark.state = BENCHMARK_STATE_IDLE;
+    isAntennaCapacitorCacheEnabled = true;
+
+    if (benchmark.resumeFrequency != 0)
+    {
+        TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, benchmark.resumeFrequency, 0);
+    }
+
+    Report_t benchmarkReport = {0};
+
+    benchmarkReport.identifier = REPORT_IDENTIFIER_ANTCAP_BENCHMARK;
+
+    memcpy(&benchmarkReport.bytes.antennaCapacitorBenchmark, report, sizeof(AntennaCapacitorBenchmarkReport_t));
+
+    return EnqueueReport(device, &benchmarkReport);
+}
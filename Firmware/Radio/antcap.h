@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file    antcap.h
+ * @brief   Header for antcap.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __ANTCAP_H__
+#define __ANTCAP_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern uint8_t LookupAntennaCapacitor(uint16_t frequency);
+extern void CacheAntennaCapacitor(uint16_t frequency, uint8_t antennaCapacitor);
+extern void SeedAntennaCapacitors(void);
+extern bool StartAntennaCapacitorBenchmark(RadioDevice_t *device);
+extern bool ProcessAntennaCapacitorBenchmark(RadioDevice_t *device);
+extern void AbortAntennaCapacitorBenchmark(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __ANTCAP_H__ */
@@ -16,11 +16,16 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "commands.h"
+#include "antcap.h"
 #include "common.h"
 #include "device.h"
 #include "i2c.h"
+#include "macros.h"
+#include "properties.h"
+#include "scan.h"
 #include "stm32f0xx_hal_def.h"
 #include "stm32f0xx_hal_i2c.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 /* Global variables ----------------------------------------------------------*/
@@ -32,8 +37,12 @@
 /* Private macros ------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
+RSQStatusResponse_t lastRSQStatus = {0};
+bool isRSQStatusKnown = false;
 
 /* Private function prototypes -----------------------------------------------*/
+void PrepareCommand(Command_t *command, CommandIdentifiers_t opCode);
+void PrepareTuneFreq(Command_t *command, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency, uint8_t antennaCapacitor);
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -50,19 +59,16 @@ bool PowerUp(RadioDevice_t *device, CMD_POWER_UP_ARGS_1 arg1, CMD_POWER_UP_ARGS_
 {
     Command_t powerUp = {0};
 
-    powerUp.args.opCode = CMD_ID_POWER_UP;
+    PrepareCommand(&powerUp, CMD_ID_POWER_UP);
+
     powerUp.args.bytes[1] = arg1;
     powerUp.args.bytes[2] = arg2;
-    powerUp.argLength = 3;
 
+    // Only the "QueryLibraryId" variant has a response
     if (arg2 & POWER_UP_ARGS_1_FUNCTION_QUERY_LIBRARY_ID)
     {
         powerUp.responseLength = 8;
     }
-    else
-    {
-        powerUp.responseLength = 0;
-    }
 
     return EnqueueCommand(device, &powerUp);
 }
@@ -77,9 +83,7 @@ bool PowerDown(RadioDevice_t *device)
 {
     Command_t powerDown = {0};
 
-    powerDown.args.opCode = CMD_ID_POWER_DOWN;
-    powerDown.argLength = 1;
-    powerDown.responseLength = 0;
+    PrepareCommand(&powerDown, CMD_ID_POWER_DOWN);
 
     return EnqueueCommand(device, &powerDown);
 }
@@ -94,9 +98,7 @@ bool GetRevision(RadioDevice_t *device)
 {
     Command_t getRevision = {0};
 
-    getRevision.args.opCode = CMD_ID_GET_REV;
-    getRevision.argLength = 1;
-    getRevision.responseLength = 16;
+    PrepareCommand(&getRevision, CMD_ID_GET_REV);
 
     return EnqueueCommand(device, &getRevision);
 
@@ -121,41 +123,60 @@ bool GetRevision(RadioDevice_t *device)
  * @param  property Identifier of the property to set
  * @param  value New value of the property
  *
- * @retval True if the command was enqueued; false otherwise
+ * @retval True if the command was enqueued, or if the property already has the value; false otherwise
  */
 bool SetProperty(RadioDevice_t *device, PropertyIdentifiers_t property, uint16_t value)
 {
     Command_t setProperty = {0};
 
-    setProperty.args.opCode = CMD_ID_SET_PROPERTY;
+    // An unchanged value is not written again, which also saves the 10 ms the set takes to complete
+    uint16_t currentValue;
+
+    if (!IsPropertyAlwaysWritten(property) && ReadPropertyShadow(device, property, &currentValue) &&
+        currentValue == value)
+    {
+        return true;
+    }
+
+    PrepareCommand(&setProperty, CMD_ID_SET_PROPERTY);
+
     setProperty.args.bytes[1] = 0x00;
     setProperty.args.bytes[2] = (uint8_t)((property & 0xFF00) >> 8);
     setProperty.args.bytes[3] = (uint8_t)((property & 0x00FF) >> 0);
     setProperty.args.bytes[4] = (uint8_t)((value & 0xFF00) >> 8);
     setProperty.args.bytes[5] = (uint8_t)((value & 0x00FF) >> 0);
-    setProperty.argLength = 6;
-    setProperty.responseLength = 0;
 
     return EnqueueCommand(device, &setProperty);
 }
 
 /**
- * @brief  Enqueues the "Get Property" command
+ * @brief  Enqueues the "Get Property" command; a property whose value is
+ *         already known is answered right away without the command
  * @param  device Pointer to the radio device structure
  * @param  property Identifier of the property to get
  *
- * @retval True if the command was enqueued; false otherwise
+ * @retval True if the command was enqueued or answered; false otherwise
  */
 bool GetProperty(RadioDevice_t *device, PropertyIdentifiers_t property)
 {
     Command_t getProperty = {0};
 
-    getProperty.args.opCode = CMD_ID_GET_PROPERTY;
+    PrepareCommand(&getProperty, CMD_ID_GET_PROPERTY);
+
     getProperty.args.bytes[1] = 0x00;
     getProperty.args.bytes[2] = (uint8_t)((property & 0xFF00) >> 8);
     getProperty.args.bytes[3] = (uint8_t)((property & 0x00FF) >> 0);
-    getProperty.argLength = 4;
-    getProperty.responseLength = 4;
+
+    uint16_t value;
+
+    if (ReadPropertyShadow(device, property, &value))
+    {
+        // Fill in the response as the radio would
+        getProperty.response[2] = (uint8_t)((value & 0xFF00) >> 8);
+        getProperty.response[3] = (uint8_t)((value & 0x00FF) >> 0);
+
+        return ProcessGetProperty(device, &getProperty);
+    }
 
     return EnqueueCommand(device, &getProperty);
 
@@ -173,15 +194,26 @@ bool GetProperty(RadioDevice_t *device, PropertyIdentifiers_t property)
  * @param  device Pointer to the radio device structure
  * @param  command Pointer to the command
  *
- * @retval True if the report was enqueued; false otherwise
+ * @retval True if the report was enqueued, or the result was consumed by a scan; false otherwise
  */
 bool ProcessGetProperty(RadioDevice_t *device, Command_t *command)
 {
+    PropertyIdentifiers_t property = (PropertyIdentifiers_t)((command->args.bytes[2] << 8) | command->args.bytes[3]);
+    uint16_t value = (uint16_t)((command->response[2] << 8) | command->response[3]);
+
+    WritePropertyShadow(property, value);
+
+    // The properties of a bulk get, and band properties requested by a scan, are not reported one by one
+    if (command->bulkIndex != 0 || ProcessScanProperty(device, command))
+    {
+        return true;
+    }
+
     Report_t report = {0};
 
     report.identifier = REPORT_IDENTIFIER_GET_PROPERTY;
 
-    report.bytes.propertyResponse.propertyValue = (uint16_t)((command->response[2] << 8) | command->response[3]);
+    report.bytes.propertyResponse.propertyValue = value;
 
     return EnqueueReport(device, &report);
 }
@@ -196,9 +228,7 @@ bool GetIntStatus(RadioDevice_t *device)
 {
     Command_t getIntStatus = {0};
 
-    getIntStatus.args.opCode = CMD_ID_GET_INT_STATUS;
-    getIntStatus.argLength = 1;
-    getIntStatus.responseLength = 1;
+    PrepareCommand(&getIntStatus, CMD_ID_GET_INT_STATUS);
 
     return EnqueueCommand(device, &getIntStatus);
 }
@@ -232,24 +262,40 @@ bool ProcessIntStatus(RadioDevice_t *device, Command_t *command)
  * @param  device Pointer to the radio device structure
  * @param  args Arguments for the command
  * @param  frequency Frequency to which the radio should tune itself, in 10 kHz increments
+ * @param  antennaCapacitor Antenna tuning capacitor value, between 1 and 191; zero uses the cached value
+ *         of the channel, or selects it automatically
  *
  * @retval True if the command was enqueued; false otherwise
  */
-bool TuneFreq(RadioDevice_t *device, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency)
+bool TuneFreq(RadioDevice_t *device, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency, uint8_t antennaCapacitor)
 {
     Command_t tuneFreq = {0};
 
-    tuneFreq.args.opCode = CMD_ID_FM_TUNE_FREQ;
-    tuneFreq.args.bytes[1] = args;
-    tuneFreq.args.bytes[2] = (uint8_t)((frequency & 0xFF00) >> 8);
-    tuneFreq.args.bytes[3] = (uint8_t)((frequency & 0x00FF) >> 0);
-    tuneFreq.args.bytes[4] = 0; // Manual ANTCAP tuning is not allowed at this point
-    tuneFreq.argLength = 5;
-    tuneFreq.responseLength = 0;
+    PrepareTuneFreq(&tuneFreq, args, frequency, antennaCapacitor);
 
     return EnqueueCommand(device, &tuneFreq);
 }
 
+/**
+ * @brief  Enqueues the "FM Tune" command ahead of every command that is still
+ *         waiting in the queue
+ * @param  device Pointer to the radio device structure
+ * @param  args Arguments for the command
+ * @param  frequency Frequency to which the radio should tune itself, in 10 kHz increments
+ * @param  antennaCapacitor Antenna tuning capacitor value, between 1 and 191; zero uses the cached value
+ *         of the channel, or selects it automatically
+ *
+ * @retval True if the command was enqueued; false otherwise
+ */
+bool PriorityTuneFreq(RadioDevice_t *device, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency, uint8_t antennaCapacitor)
+{
+    Command_t tuneFreq = {0};
+
+    PrepareTuneFreq(&tuneFreq, args, frequency, antennaCapacitor);
+
+    return EnqueuePriorityCommand(device, &tuneFreq);
+}
+
 /**
  * @brief  Enqueues the "Seek Start" command
  * @param  device Pointer to the radio device structure
@@ -261,10 +307,9 @@ bool SeekStart(RadioDevice_t *device, CMD_FM_SEEK_START_ARGS args)
 {
     Command_t seekStart = {0};
 
-    seekStart.args.opCode = CMD_ID_FM_SEEK_START;
+    PrepareCommand(&seekStart, CMD_ID_FM_SEEK_START);
+
     seekStart.args.bytes[1] = args;
-    seekStart.argLength = 2;
-    seekStart.responseLength = 0;
 
     return EnqueueCommand(device, &seekStart);
 }
@@ -280,10 +325,9 @@ bool TuneStatus(RadioDevice_t *device, CMD_GET_TUNE_STATUS_ARGS args)
 {
     Command_t getTuneStatus = {0};
 
-    getTuneStatus.args.opCode = CMD_ID_FM_TUNE_STATUS;
+    PrepareCommand(&getTuneStatus, CMD_ID_FM_TUNE_STATUS);
+
     getTuneStatus.args.bytes[1] = args;
-    getTuneStatus.argLength = 2;
-    getTuneStatus.responseLength = 8;
 
     return EnqueueCommand(device, &getTuneStatus);
 
@@ -303,6 +347,56 @@ bool TuneStatus(RadioDevice_t *device, CMD_GET_TUNE_STATUS_ARGS args)
     // return true;
 }
 
+/**
+ * @brief  Enqueues the response of the "Get Tune Status" command as a new
+ *         report, so the host gets the signal quality right after a tune
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ProcessTuneStatus(RadioDevice_t *device, Command_t *command)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_TUNE_STATUS;
+
+    report.bytes.tuneStatus.bandLimit = command->response[1] & 0x80;
+    report.bytes.tuneStatus.AFCRail = command->response[1] & 0x02;
+    report.bytes.tuneStatus.validChannel = command->response[1] & 0x01;
+
+    report.bytes.tuneStatus.frequency = (uint16_t)((command->response[2] << 8) | (command->response[3] << 0));
+    report.bytes.tuneStatus.rssi = command->response[4];
+    report.bytes.tuneStatus.snr = command->response[5];
+    report.bytes.tuneStatus.multipath = command->response[6];
+    report.bytes.tuneStatus.antennaCapacitor = command->response[7];
+
+    return EnqueueReport(device, &report);
+}
+
+/**
+ * @brief  Enqueues the response of a "Get Tune Status" command polled during
+ *         a seek as a new progress report
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ProcessSeekProgress(RadioDevice_t *device, Command_t *command)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_SEEK_PROGRESS;
+
+    report.bytes.seekProgress.frequency = (uint16_t)((command->response[2] << 8) | (command->response[3] << 0));
+    report.bytes.seekProgress.rssi = command->response[4];
+    report.bytes.seekProgress.snr = command->response[5];
+    report.bytes.seekProgress.bandLimit = command->response[1] & 0x80;
+    report.bytes.seekProgress.isCancelled = command->args.bytes[1] & GET_TUNE_STATUS_ARGS_CANCEL;
+
+    return EnqueueReport(device, &report);
+}
+
 /**
  * @brief  Enqueues the "FM RSQ Status" command
  * @param  device Pointer to the radio device structure
@@ -314,10 +408,9 @@ bool RSQStatus(RadioDevice_t *device, CMD_FM_RSQ_STATUS_ARGS args)
 {
     Command_t rsqStatus = {0};
 
-    rsqStatus.args.opCode = CMD_ID_FM_RSQ_STATUS;
+    PrepareCommand(&rsqStatus, CMD_ID_FM_RSQ_STATUS);
+
     rsqStatus.args.bytes[1] = args;
-    rsqStatus.argLength = 2;
-    rsqStatus.responseLength = 8;
 
     return EnqueueCommand(device, &rsqStatus);
 }
@@ -355,9 +448,50 @@ bool ProcessRSQStatus(RadioDevice_t *device, Command_t *command)
     report.bytes.rsqStatus.multipath = command->response[6];
     report.bytes.rsqStatus.frequencyOffset = (int8_t)command->response[7];
 
+    // Read by the "FM AGC Status" command that precedes every periodic RSQ reading
+    report.bytes.rsqStatus.isAGCDisabled = device->isAGCDisabled;
+    report.bytes.rsqStatus.lnaGainIndex = device->lnaGainIndex;
+
+    // Kept for the host to read as a snapshot outside the periodic reports
+    lastRSQStatus = report.bytes.rsqStatus;
+    isRSQStatusKnown = true;
+
     return EnqueueReport(device, &report);
 }
 
+/**
+ * @brief  Gets the most recent result of "FM RSQ Status" command
+ * @param  status Pointer to the status to fill in
+ *
+ * @retval True if a status has been read since boot; false otherwise
+ */
+bool GetLastRSQStatus(RSQStatusResponse_t *status)
+{
+    if (!isRSQStatusKnown)
+    {
+        return false;
+    }
+
+    *status = lastRSQStatus;
+
+    return true;
+}
+
+/**
+ * @brief  Stores the result of "FM AGC Status" command, which is reported along with the next RSQ reading
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the result is always stored
+ */
+bool ProcessAGCStatus(RadioDevice_t *device, Command_t *command)
+{
+    device->isAGCDisabled = command->response[1] & 0x01;
+    device->lnaGainIndex = command->response[2] & 0x1F;
+
+    return true;
+}
+
 /**
  * @brief  Enqueues the "FM RDS Status" command
  * @param  device Pointer to the radio device structure
@@ -369,10 +503,9 @@ bool RDSStatus(RadioDevice_t *device, CMD_FM_RDS_STATUS_ARGS args)
 {
     Command_t rdsStatus = {0};
 
-    rdsStatus.args.opCode = CMD_ID_FM_RDS_STATUS;
+    PrepareCommand(&rdsStatus, CMD_ID_FM_RDS_STATUS);
+
     rdsStatus.args.bytes[1] = args;
-    rdsStatus.argLength = 2;
-    rdsStatus.responseLength = 13;
 
     return EnqueueCommand(device, &rdsStatus);
 }
@@ -388,10 +521,9 @@ bool GPIOCtl(RadioDevice_t *device, CMD_GPIO_CTL_ARGS args)
 {
     Command_t gpioCtl = {0};
 
-    gpioCtl.args.opCode = CMD_ID_GPIO_CTL;
+    PrepareCommand(&gpioCtl, CMD_ID_GPIO_CTL);
+
     gpioCtl.args.bytes[1] = args;
-    gpioCtl.argLength = 2;
-    gpioCtl.responseLength = 0;
 
     return EnqueueCommand(device, &gpioCtl);
 }
@@ -407,14 +539,113 @@ bool GPIOSet(RadioDevice_t *device, CMD_GPIO_SET_ARGS args)
 {
     Command_t gpioSet = {0};
 
-    gpioSet.args.opCode = CMD_ID_GPIO_SET;
+    PrepareCommand(&gpioSet, CMD_ID_GPIO_SET);
+
     gpioSet.args.bytes[1] = args;
-    gpioSet.argLength = 2;
-    gpioSet.responseLength = 0;
 
     return EnqueueCommand(device, &gpioSet);
 }
 
+/**
+ * @brief  Enqueues the "FM AGC Status" command
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the command was enqueued; false otherwise
+ */
+bool AGCStatus(RadioDevice_t *device)
+{
+    Command_t agcStatus = {0};
+
+    PrepareCommand(&agcStatus, CMD_ID_FM_AGC_STATUS);
+
+    return EnqueueCommand(device, &agcStatus);
+}
+
+/**
+ * @brief  Enqueues the "FM AGC Override" command
+ * @param  device Pointer to the radio device structure
+ * @param  args Arguments to the command
+ * @param  gainIndex LNA gain index used while the RF AGC is disabled, between 0 (minimum attenuation) and 26
+ *         (maximum attenuation)
+ *
+ * @retval True if the command was enqueued; false otherwise
+ */
+bool AGCOverride(RadioDevice_t *device, CMD_FM_AGC_OVERRIDE_ARGS args, uint8_t gainIndex)
+{
+    Command_t agcOverride = {0};
+
+    if (gainIndex > SI4705_LNA_GAIN_INDEX_MAX_SETTING)
+    {
+        gainIndex = SI4705_LNA_GAIN_INDEX_MAX_SETTING;
+    }
+
+    PrepareCommand(&agcOverride, CMD_ID_FM_AGC_OVERRIDE);
+
+    agcOverride.args.bytes[1] = args;
+    agcOverride.args.bytes[2] = gainIndex;
+
+    return EnqueueCommand(device, &agcOverride);
+}
+
+/**
+ * @brief  Enqueues the commands that power up the radio, and configure its
+ *         interrupts, GPO pins and RDS; the station and the audio settings
+ *         are left for the caller to apply
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the commands were enqueued; false otherwise
+ *
+ * @remark The commands are the built-in boot macro, which the host may also run
+ */
+bool StartRadio(RadioDevice_t *device)
+{
+    return RunMacro(device, MACRO_ID_BOOT);
+}
+
 /* External callbacks --------------------------------------------------------*/
 
 /* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Fills in the opcode of the command, and the argument and response
+ *         lengths given by its descriptor
+ * @param  command Pointer to the command
+ * @param  opCode Opcode of the command
+ */
+void PrepareCommand(Command_t *command, CommandIdentifiers_t opCode)
+{
+    const CommandDescriptor_t *descriptor = GetCommandDescriptor(opCode);
+
+    command->args.opCode = opCode;
+    command->argLength = descriptor->argLength;
+    command->responseLength = descriptor->responseLength;
+}
+
+/**
+ * @brief  Fills in the "FM Tune" command
+ * @param  command Pointer to the command
+ * @param  args Arguments for the command
+ * @param  frequency Frequency to which the radio should tune itself, in 10 kHz increments
+ * @param  antennaCapacitor Antenna tuning capacitor value, between 1 and 191; zero uses the cached value
+ *         of the channel, or selects it automatically
+ */
+void PrepareTuneFreq(Command_t *command, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency, uint8_t antennaCapacitor)
+{
+    if (antennaCapacitor > SI4705_ANTCAP_MAX_SETTING)
+    {
+        antennaCapacitor = 0;
+    }
+
+    // Reuse the value the radio chose on an earlier tune to this channel
+    if (antennaCapacitor == 0)
+    {
+        antennaCapacitor = LookupAntennaCapacitor(frequency);
+    }
+
+    PrepareCommand(command, CMD_ID_FM_TUNE_FREQ);
+
+    command->args.bytes[1] = args;
+    command->args.bytes[2] = (uint8_t)((frequency & 0xFF00) >> 8);
+    command->args.bytes[3] = (uint8_t)((frequency & 0x00FF) >> 0);
+    command->args.bytes[4] = antennaCapacitor;
+}
@@ -166,6 +166,15 @@ typedef enum _CMD_GPIO_SET_ARGS : uint8_t
     GPIO_SET_GPO3_OUTPUT_HIGH = 0x80,
 } CMD_GPIO_SET_ARGS;
 
+typedef enum _CMD_FM_AGC_OVERRIDE_ARGS : uint8_t
+{
+    /* The RF AGC is enabled, and it chooses the LNA gain index */
+    FM_AGC_OVERRIDE_ARGS_NONE = 0x00,
+
+    /* When set, the RF AGC is disabled and the given LNA gain index is used */
+    FM_AGC_OVERRIDE_ARGS_RFAGCDIS = 0x01,
+} CMD_FM_AGC_OVERRIDE_ARGS;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macros -----------------------------------------------------------*/
@@ -179,17 +188,26 @@ extern bool GetRevision(RadioDevice_t *device);
 extern bool SetProperty(RadioDevice_t *device, PropertyIdentifiers_t property, uint16_t value);
 extern bool GetProperty(RadioDevice_t *device, PropertyIdentifiers_t property);
 extern bool GetIntStatus(RadioDevice_t *device);
-extern bool TuneFreq(RadioDevice_t *device, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency);
+extern bool TuneFreq(RadioDevice_t *device, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency, uint8_t antennaCapacitor);
+extern bool PriorityTuneFreq(RadioDevice_t *device, CMD_FM_TUNE_FREQ_ARGS args, uint16_t frequency,
+                             uint8_t antennaCapacitor);
 extern bool SeekStart(RadioDevice_t *device, CMD_FM_SEEK_START_ARGS args);
 extern bool TuneStatus(RadioDevice_t *device, CMD_GET_TUNE_STATUS_ARGS args);
 extern bool RSQStatus(RadioDevice_t *device, CMD_FM_RSQ_STATUS_ARGS args);
 extern bool RDSStatus(RadioDevice_t *device, CMD_FM_RDS_STATUS_ARGS args);
 extern bool GPIOCtl(RadioDevice_t *device, CMD_GPIO_CTL_ARGS args);
 extern bool GPIOSet(RadioDevice_t *device, CMD_GPIO_SET_ARGS args);
+extern bool AGCStatus(RadioDevice_t *device);
+extern bool AGCOverride(RadioDevice_t *device, CMD_FM_AGC_OVERRIDE_ARGS args, uint8_t gainIndex);
+extern bool StartRadio(RadioDevice_t *device);
 
 extern bool ProcessIntStatus(RadioDevice_t *device, Command_t *command);
 extern bool ProcessGetProperty(RadioDevice_t *device, Command_t *command);
 extern bool ProcessRSQStatus(RadioDevice_t *device, Command_t *command);
+extern bool GetLastRSQStatus(RSQStatusResponse_t *status);
+extern bool ProcessAGCStatus(RadioDevice_t *device, Command_t *command);
+extern bool ProcessTuneStatus(RadioDevice_t *device, Command_t *command);
+extern bool ProcessSeekProgress(RadioDevice_t *device, Command_t *command);
 
 #ifdef __cplusplus
 }
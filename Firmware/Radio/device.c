@@ -17,14 +17,25 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "device.h"
+#include "af.h"
+#include "antcap.h"
+#include "audio_monitor.h"
+#include "boot.h"
 #include "commands.h"
 #include "common.h"
 #include "i2c.h"
+#include "macros.h"
 #include "main.h"
+#include "passthrough.h"
+#include "properties.h"
 #include "rds.h"
+#include "scan.h"
 #include "stm32f0xx_hal.h"
+#include "supervisor.h"
+#include "telemetry.h"
 #include "tim.h"
 #include "tusb.h"
+#include <string.h>
 
 /* Global variables ----------------------------------------------------------*/
 
@@ -34,8 +45,14 @@ RadioDevice_t radioDevice = {
     .currentState = RADIOSTATE_POWERDOWN,
     .currentFrequency = 0,
     .currentVolume = SI4705_VOLUME_MAX_SETTING / 2,
-    .interruptCounter = 0,
+    .pendingInterrupts = 0,
     .isMuted = false,
+    .currentDeemphasis = 0,
+    .currentAntennaCapacitor = 0,
+    .isAGCDisabled = false,
+    .lnaGainIndex = 0,
+    .lastTuneDuration = 0,
+    .oscillatorReadyTick = 0,
     .commandQueue = {
         .commands = {{0}},
         .count = 0,
@@ -46,20 +63,148 @@ RadioDevice_t radioDevice = {
 // clang-format on
 
 /* Private types -------------------------------------------------------------*/
+typedef struct _InterruptStatistics_t
+{
+    /* Number of status reads after an interrupt, and of those that found no newly raised source */
+    uint16_t wakeups;
+    uint16_t spuriousWakeups;
+
+    /* Per source, in the order of interruptSources */
+    uint16_t counts[INTERRUPT_SOURCE_COUNT];
+    uint16_t spuriousCounts[INTERRUPT_SOURCE_COUNT];
+    uint16_t maximumLatency[INTERRUPT_SOURCE_COUNT];
+    uint32_t totalLatency[INTERRUPT_SOURCE_COUNT];
+} InterruptStatistics_t;
 
 /* Private constants ---------------------------------------------------------*/
 
+// Interval of the tune status polls while a seek is in progress, in ms
+#define SEEK_PROGRESS_INTERVAL 100
+
+// The radio must be held in reset at least 100 µs
+#define RADIO_RESET_TIME 100
+
+// Tuner programming guide outlines that a property set operation always completes in 10 ms;
+// one tick more than that, as the first tick may be partial
+#define SET_PROPERTY_SETTLE_TIME 11
+
+// Maps an opcode to its slot in the descriptor table; the GPIO opcodes 0x80 and 0x81
+// fold into the slots 0x08 and 0x09, which no other opcode uses
+#define COMMAND_DESCRIPTOR_SLOT(opCode) (uint8_t)(((opCode) & 0x3F) | (((opCode) & 0x80) >> 4))
+
+// Number of slots in the descriptor table; the last opcode below 0x80 has the highest slot
+#define COMMAND_DESCRIPTOR_COUNT (COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_AGC_OVERRIDE) + 1)
+
+// Interval of the radio status heartbeat until the host sets one, and the shortest one it may set, in ms
+#define RADIO_STATUS_HEARTBEAT_DEFAULT 5000
+#define RADIO_STATUS_HEARTBEAT_MIN 100
+
+// Status byte bits that raise the interrupt line
+#define SI4705_STATUS_SOURCES                                                                                          \
+    (SI4705_STATUS_CTS | SI4705_STATUS_ERR | SI4705_STATUS_RSQINT | SI4705_STATUS_RDSINT | SI4705_STATUS_STCINT)
+
+// Interrupt sources in the order of the interrupt statistics report
+const uint8_t interruptSources[INTERRUPT_SOURCE_COUNT] = {
+    SI4705_STATUS_CTS, SI4705_STATUS_STCINT, SI4705_STATUS_RDSINT, SI4705_STATUS_RSQINT, SI4705_STATUS_ERR,
+};
+
 /* Private macros ------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
 volatile bool i2cTransferInterruptRaised = false;
 volatile bool i2cReceiveInterruptRaised = false;
 
+// Command sent past the queue while the front command waits for STC
+volatile Command_t sideCommand = {0};
+
+// Tick at which the next seek progress poll is due
+uint32_t nextSeekPollTick = 0;
+
+// Set when the host has asked to cancel the seek in progress
+volatile bool isSeekCancelRequested = false;
+
+// Time at which the command in progress was sent, in µs
+uint32_t commandStartMicroseconds = 0;
+
+// Tick before which the next command is not sent
+uint32_t commandSettleTick = 0;
+
+// Set by the interrupt line, along with the time of the first edge since the status was last read, in µs
+volatile bool isInterruptRaised = false;
+volatile uint32_t interruptMicroseconds = 0;
+
+// Set while the status byte is read after an interrupt, and when the read has completed
+volatile bool isStatusReadInProgress = false;
+volatile bool isStatusReceived = false;
+
+// Status byte read after the latest interrupt, and the time of the edge that it covers, in µs
+uint8_t interruptStatus = 0;
+uint32_t wakeupMicroseconds = 0;
+
+// Sources that were already raised in the previous status; only the newly raised ones are counted
+uint8_t previousInterruptStatus = 0;
+
+// Radio status in the latest status report; a change from it is reported right away
+RadioStatusResponse_t reportedRadioStatus = {0};
+bool isRadioStatusReported = false;
+
+// Interval of the status reports sent when nothing has changed, in ms; zero sends them only on change
+uint16_t radioStatusHeartbeat = RADIO_STATUS_HEARTBEAT_DEFAULT;
+
+// Tick at which the next heartbeat is due
+uint32_t nextRadioStatusTick = 0;
+
+// Sequence number of the next report
+uint8_t reportSequence = 0;
+
+// Interrupt servicing counters for the current report window, and set by timer 17 when the window is due for reporting
+InterruptStatistics_t interruptStatistics = {0};
+volatile bool isInterruptStatisticsDue = false;
+
 /* Private function prototypes -----------------------------------------------*/
 bool IsCommandQueueEmpty(CommandQueue_t *queue);
 Command_t *PeekCommand(CommandQueue_t *queue);
 Command_t *PopCommand(CommandQueue_t *queue);
 Report_t *PopReport(ReportQueue_t *queue);
+bool IsCommandQueued(RadioDevice_t *device, CommandIdentifiers_t opCode);
+bool IsBusBusy(RadioDevice_t *device);
+bool StartSideCommand(RadioDevice_t *device, CMD_GET_TUNE_STATUS_ARGS args);
+bool ProcessSideCommand(RadioDevice_t *device);
+bool ProcessInterrupts(RadioDevice_t *device);
+void ServiceInterrupts(RadioDevice_t *device, uint8_t status, uint32_t edgeMicroseconds);
+void ClearInterrupts(RadioDevice_t *device, uint8_t sources);
+void IncrementCounter(uint16_t *counter);
+void WriteReportEnvelope(Report_t *report, uint8_t sequence);
+bool CompletePowerUp(RadioDevice_t *device, Command_t *command);
+bool CompletePowerDown(RadioDevice_t *device, Command_t *command);
+bool CompleteSetProperty(RadioDevice_t *device, Command_t *command);
+bool CompleteIntStatus(RadioDevice_t *device, Command_t *command);
+bool CompleteTune(RadioDevice_t *device, Command_t *command);
+bool CompleteTuneStatus(RadioDevice_t *device, Command_t *command);
+bool CompleteRSQStatus(RadioDevice_t *device, Command_t *command);
+bool CompleteRDSStatus(RadioDevice_t *device, Command_t *command);
+
+// clang-format off
+// Describes every command the radio is sent, in flash; the commands not listed have an all-zero entry
+const CommandDescriptor_t commandDescriptors[COMMAND_DESCRIPTOR_COUNT] = {
+    //                                                     opcode                  args  response  wait              settle                    completion handler
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_POWER_UP)]         = { CMD_ID_POWER_UP,        3,    0,        COMMANDWAIT_CTS,  0,                        CompletePowerUp },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_GET_REV)]          = { CMD_ID_GET_REV,         1,    16,       COMMANDWAIT_CTS,  0,                        NULL },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_POWER_DOWN)]       = { CMD_ID_POWER_DOWN,      1,    0,        COMMANDWAIT_CTS,  0,                        CompletePowerDown },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_SET_PROPERTY)]     = { CMD_ID_SET_PROPERTY,    6,    0,        COMMANDWAIT_CTS,  SET_PROPERTY_SETTLE_TIME, CompleteSetProperty },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_GET_PROPERTY)]     = { CMD_ID_GET_PROPERTY,    4,    4,        COMMANDWAIT_CTS,  0,                        ProcessGetProperty },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_GET_INT_STATUS)]   = { CMD_ID_GET_INT_STATUS,  1,    1,        COMMANDWAIT_CTS,  0,                        CompleteIntStatus },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_TUNE_FREQ)]     = { CMD_ID_FM_TUNE_FREQ,    5,    0,        COMMANDWAIT_STC,  0,                        CompleteTune },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_SEEK_START)]    = { CMD_ID_FM_SEEK_START,   2,    0,        COMMANDWAIT_STC,  0,                        CompleteTune },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_TUNE_STATUS)]   = { CMD_ID_FM_TUNE_STATUS,  2,    8,        COMMANDWAIT_CTS,  0,                        CompleteTuneStatus },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_RSQ_STATUS)]    = { CMD_ID_FM_RSQ_STATUS,   2,    8,        COMMANDWAIT_CTS,  0,                        CompleteRSQStatus },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_RDS_STATUS)]    = { CMD_ID_FM_RDS_STATUS,   2,    13,       COMMANDWAIT_CTS,  0,                        CompleteRDSStatus },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_AGC_STATUS)]    = { CMD_ID_FM_AGC_STATUS,   1,    3,        COMMANDWAIT_CTS,  0,                        ProcessAGCStatus },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_FM_AGC_OVERRIDE)]  = { CMD_ID_FM_AGC_OVERRIDE, 3,    0,        COMMANDWAIT_CTS,  0,                        NULL },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_GPIO_CTL)]         = { CMD_ID_GPIO_CTL,        2,    0,        COMMANDWAIT_CTS,  0,                        NULL },
+    [COMMAND_DESCRIPTOR_SLOT(CMD_ID_GPIO_SET)]         = { CMD_ID_GPIO_SET,        2,    0,        COMMANDWAIT_CTS,  0,                        NULL },
+};
+// clang-format on
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -71,17 +216,68 @@ Report_t *PopReport(ReportQueue_t *queue);
  */
 bool ProcessCommand(RadioDevice_t *device)
 {
+    // The radio cannot respond until its oscillator has started up; the
+    // commands just wait in the queue until then
+    if (!HasBootMilestone(BOOT_MILESTONE_OSCILLATOR_READY))
+    {
+        if ((int32_t)(HAL_GetTick() - device->oscillatorReadyTick) < 0)
+        {
+            CheckIn(SUBSYSTEM_COMMAND_ENGINE);
+
+            return false;
+        }
+
+        RecordBootMilestone(BOOT_MILESTONE_OSCILLATOR_READY);
+    }
+
+    // The status read after an interrupt owns the I2C bus until it has completed
+    if (ProcessInterrupts(device))
+    {
+        return true;
+    }
+
+    // The side command owns the I2C bus until it has completed
+    if (sideCommand.state != COMMANDSTATE_IDLE)
+    {
+        return ProcessSideCommand(device);
+    }
+
     volatile Command_t *currentCommand = PeekCommand(&device->commandQueue);
 
+    // An idle engine is a healthy one; a busy one checks in as its commands complete
     if (currentCommand == NULL)
     {
+        CheckIn(SUBSYSTEM_COMMAND_ENGINE);
+
         return false;
     }
 
+    const CommandDescriptor_t *descriptor = GetCommandDescriptor(currentCommand->args.opCode);
+
     if (currentCommand->state == COMMANDSTATE_IDLE)
     {
+        // The previous command is still taking effect in the radio
+        if ((int32_t)(HAL_GetTick() - commandSettleTick) < 0)
+        {
+            return true;
+        }
+
         currentCommand->state = COMMANDSTATE_SENDING;
 
+        // The radio clears CTS and ERR as it receives the command, and STC as a tune or seek begins
+        if (descriptor->wait == COMMANDWAIT_STC)
+        {
+            ClearInterrupts(device, SI4705_STATUS_CTS | SI4705_STATUS_ERR | SI4705_STATUS_STCINT);
+        }
+        else
+        {
+            ClearInterrupts(device, SI4705_STATUS_CTS | SI4705_STATUS_ERR);
+        }
+
+        commandStartMicroseconds = GetMicroseconds();
+
+        RecordI2CTransferStart();
+
         HAL_StatusTypeDef status = HAL_I2C_Master_Transmit_IT(
             &hi2c1, device->deviceAddress, (uint8_t *)&currentCommand->args, currentCommand->argLength);
 
@@ -96,11 +292,13 @@ bool ProcessCommand(RadioDevice_t *device)
     {
         i2cTransferInterruptRaised = false;
 
-        if (currentCommand->args.opCode == CMD_ID_FM_TUNE_FREQ || currentCommand->args.opCode == CMD_ID_FM_SEEK_START)
+        if (descriptor->wait == COMMANDWAIT_STC)
         {
             radioDevice.currentState = RADIOSTATE_TUNE_IN_PROGRESS;
 
             currentCommand->state = COMMANDSTATE_WAITING_FOR_STC;
+
+            nextSeekPollTick = HAL_GetTick() + SEEK_PROGRESS_INTERVAL;
         }
         else
         {
@@ -109,17 +307,43 @@ bool ProcessCommand(RadioDevice_t *device)
 
         return true;
     }
-    else if (currentCommand->state == COMMANDSTATE_WAITING_FOR_STC && radioDevice.interruptCounter > 0)
+    else if (currentCommand->state == COMMANDSTATE_WAITING_FOR_STC &&
+             (device->pendingInterrupts & SI4705_STATUS_STCINT))
     {
-        radioDevice.interruptCounter--;
+        device->pendingInterrupts &= (uint8_t)~SI4705_STATUS_STCINT;
+
+        device->lastTuneDuration = GetMicroseconds() - commandStartMicroseconds;
 
         currentCommand->state = COMMANDSTATE_WAITING_FOR_CTS;
 
         return true;
     }
-    else if (currentCommand->state == COMMANDSTATE_WAITING_FOR_CTS && radioDevice.interruptCounter > 0)
+    else if (currentCommand->state == COMMANDSTATE_WAITING_FOR_STC &&
+             currentCommand->args.opCode == CMD_ID_FM_SEEK_START)
+    {
+        // A seek across an empty band takes seconds; poll the tune status
+        // past the queue to report the progress, or to cancel the seek
+        if (isSeekCancelRequested)
+        {
+            isSeekCancelRequested = false;
+
+            StartSideCommand(device, GET_TUNE_STATUS_ARGS_CANCEL);
+        }
+        else if ((int32_t)(HAL_GetTick() - nextSeekPollTick) >= 0)
+        {
+            nextSeekPollTick = HAL_GetTick() + SEEK_PROGRESS_INTERVAL;
+
+            StartSideCommand(device, GET_TUNE_STATUS_ARGS_NONE);
+        }
+
+        return true;
+    }
+    else if (currentCommand->state == COMMANDSTATE_WAITING_FOR_CTS && (device->pendingInterrupts & SI4705_STATUS_CTS))
     {
-        radioDevice.interruptCounter--;
+        // Without a response to read, the status byte is kept as the response, so an error is noticed on completion
+        currentCommand->response[0] = device->pendingInterrupts & (SI4705_STATUS_CTS | SI4705_STATUS_ERR);
+
+        device->pendingInterrupts &= (uint8_t)~(SI4705_STATUS_CTS | SI4705_STATUS_ERR);
 
         if (currentCommand->responseLength > 0)
         {
@@ -136,6 +360,8 @@ bool ProcessCommand(RadioDevice_t *device)
     {
         currentCommand->state = COMMANDSTATE_RECEIVING_RESPONSE;
 
+        RecordI2CTransferStart();
+
         HAL_StatusTypeDef status = HAL_I2C_Master_Receive_IT(
             &hi2c1, device->deviceAddress, (uint8_t *)&currentCommand->response, currentCommand->responseLength);
 
@@ -156,144 +382,54 @@ bool ProcessCommand(RadioDevice_t *device)
     }
     else if (currentCommand->state == COMMANDSTATE_RESPONSE_RECEIVED)
     {
-        switch (currentCommand->args.opCode)
-        {
-        case CMD_ID_GET_INT_STATUS:
-            ProcessIntStatus(device, (Command_t *)currentCommand);
-            break;
-
-        case CMD_ID_GET_PROPERTY:
-            ProcessGetProperty(device, (Command_t *)currentCommand);
-            break;
-
-        case CMD_ID_FM_RSQ_STATUS:
-            ProcessRSQStatus(device, (Command_t *)currentCommand);
-            break;
-
-        default:
-            break;
-        }
-
+        // The response is processed by the completion handler of the command
         currentCommand->state = COMMANDSTATE_READY;
     }
     else if (currentCommand->state == COMMANDSTATE_READY)
     {
-        if (currentCommand->args.opCode == CMD_ID_POWER_UP && currentCommand->responseLength == 0)
+        // A command the radio rejected has no effect, and no valid response to process
+        if (descriptor->complete != NULL && !(currentCommand->response[0] & SI4705_STATUS_ERR))
         {
-            device->currentState = RADIOSTATE_POWERUP;
+            descriptor->complete(device, (Command_t *)currentCommand);
         }
-        else if (currentCommand->args.opCode == CMD_ID_POWER_DOWN)
-        {
-            device->currentState = RADIOSTATE_POWERDOWN;
-
-            HAL_TIM_Base_Stop(&htim16);
-        }
-        else if (currentCommand->args.opCode == CMD_ID_FM_TUNE_FREQ ||
-                 currentCommand->args.opCode == CMD_ID_FM_SEEK_START)
-        {
-            device->currentState = RADIOSTATE_TUNED_TO_STATION;
-
-            HAL_TIM_Base_Start_IT(&htim16);
 
-            // After tuning or seek has completed, set the sample rate so the chip begins sending audio samples
-            SetProperty(&radioDevice, PROP_ID_DIGITAL_OUTPUT_SAMPLE_RATE, CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE);
+        uint32_t duration = GetMicroseconds() - commandStartMicroseconds;
 
-            // Schedule a GetTuneStatus to update the current frequency reading and clear the STCINT bit
-            TuneStatus(device, GET_TUNE_STATUS_ARGS_INTACK);
-
-            // Reset the RDS parser state
-            RDSReset();
-        }
-        else if (currentCommand->args.opCode == CMD_ID_FM_TUNE_STATUS)
+        // A command the host passed through returns its response, error or not
+        if (currentCommand->correlationId != 0)
         {
-            // If the channel is valid, update the frequency reading; otherwise reset it to zero
-            if (currentCommand->response[1] & 0x01)
-            {
-                device->currentFrequency =
-                    (uint16_t)((currentCommand->response[2] << 8) | (currentCommand->response[3] << 0));
-            }
-            else
-            {
-                device->currentFrequency = 0;
-            }
+            ReportPassthroughResponse(device, (Command_t *)currentCommand, duration);
         }
-        else if (currentCommand->args.opCode == CMD_ID_GET_INT_STATUS)
-        {
-            // bool clearToSend = currentCommand->response[0] & 0x80;
-            // bool error = currentCommand->response[0] & 0x40;
-            // bool rsqInterrupt = currentCommand->response[0] & 0x08;
-            bool rdsInterrupt = currentCommand->response[0] & 0x04;
-            // bool seekTuneCompleted = currentCommand->response[0] & 0x01;
 
-            if (rdsInterrupt)
-            {
-                RDSStatus(device, FM_RDS_STATUS_ARGS_INTACK);
-            }
-        }
-        else if (currentCommand->args.opCode == CMD_ID_SET_PROPERTY)
+        // The macro is reported once, after its last command
+        if (currentCommand->isMacroCommand)
         {
-            PropertyIdentifiers_t property =
-                (PropertyIdentifiers_t)((currentCommand->args.bytes[2] << 8) | (currentCommand->args.bytes[3] << 0));
-
-            uint16_t value = (uint16_t)((currentCommand->args.bytes[4] << 8) | (currentCommand->args.bytes[5] << 0));
-
-            if (property == PROP_ID_DIGITAL_OUTPUT_SAMPLE_RATE)
-            {
-                if (value != 0)
-                {
-                    device->currentState = RADIOSTATE_DIGITAL_OUTPUT_ENABLED;
-                }
-                else
-                {
-                    device->currentState = RADIOSTATE_TUNED_TO_STATION;
-                }
-            }
-            else if (property == PROP_ID_RX_VOLUME)
-            {
-                device->currentVolume = value;
-            }
-            else if (property == PROP_ID_RX_HARD_MUTE)
-            {
-                if (value == 0)
-                {
-                    device->isMuted = false;
-                }
-                else if (value & 0b11)
-                {
-                    device->isMuted = true;
-                }
-
-                // Per-channel mute status is not supported
-            }
-
-            // Tuner programming guide outlines that a property
-            // set operation always completes in 10 ms
-            HAL_Delay(10);
+            CompleteMacroCommand(device, (Command_t *)currentCommand);
         }
-        else if (currentCommand->args.opCode == CMD_ID_FM_RDS_STATUS)
-        {
-            uint8_t fifoCount = currentCommand->response[3];
 
-            uint16_t blockA = (uint16_t)((currentCommand->response[4] << 8) | (currentCommand->response[5] << 0));
-            uint16_t blockB = (uint16_t)((currentCommand->response[6] << 8) | (currentCommand->response[7] << 0));
-            uint16_t blockC = (uint16_t)((currentCommand->response[8] << 8) | (currentCommand->response[9] << 0));
-            uint16_t blockD = (uint16_t)((currentCommand->response[10] << 8) | (currentCommand->response[11] << 0));
+        // A bulk transfer records the outcome of each of its properties, error or not
+        if (currentCommand->bulkIndex != 0)
+        {
+            ProcessPropertyBulkResponse(device, (Command_t *)currentCommand);
+        }
 
-            uint8_t blockAErrors = currentCommand->response[12] & 0xC0;
-            uint8_t blockBErrors = currentCommand->response[12] & 0x30;
-            uint8_t blockCErrors = currentCommand->response[12] & 0x0C;
-            uint8_t blockDErrors = currentCommand->response[12] & 0x03;
+        RecordCommandLatency(currentCommand->args.opCode, duration);
 
-            ProcessRDSData(blockA, blockB, blockC, blockD, blockAErrors, blockBErrors, blockCErrors, blockDErrors);
+        // Hold back the next command until this one has taken effect in the radio
+        if (descriptor->settleTime > 0)
+        {
+            commandSettleTick = HAL_GetTick() + descriptor->settleTime;
+        }
 
-            if (fifoCount > 0)
-            {
-                // Schedule a new retrieval until the FIFO is empty
-                RDSStatus(device, FM_RDS_STATUS_ARGS_NONE);
-            }
+        // A cancel that arrived too late for this seek must not carry over to the next one
+        if (currentCommand->args.opCode == CMD_ID_FM_SEEK_START)
+        {
+            isSeekCancelRequested = false;
         }
 
         PopCommand(&device->commandQueue);
+
+        CheckIn(SUBSYSTEM_COMMAND_ENGINE);
     }
 
     // Current command is executing; nothing to do at this time
@@ -308,14 +444,28 @@ bool ProcessCommand(RadioDevice_t *device)
  */
 bool ProcessReport(RadioDevice_t *device)
 {
-    Report_t *currentReport = PopReport(&device->reportQueue);
+    ReportQueue_t *queue = &device->reportQueue;
+
+    // A report takes several frames of the IN endpoint; until the previous one has
+    // been sent, the next one stays at the front of the queue
+    if (queue->count == 0 || !tud_hid_ready())
+    {
+        return false;
+    }
 
-    if (currentReport == NULL)
+    Report_t *currentReport = &queue->reports[queue->front];
+
+    if (!tud_hid_report(currentReport->identifier, currentReport->bytes.raw, MAX_STRUCT_SIZE))
     {
+        // A failed send is counted with the dropped reports; the report stays at the front and is tried again
+        RecordDroppedEnqueue(TELEMETRY_QUEUE_REPORT);
+
         return false;
     }
 
-    return tud_hid_report(currentReport->identifier, currentReport->bytes.raw, MAX_STRUCT_SIZE);
+    PopReport(queue);
+
+    return true;
 }
 
 /**
@@ -337,6 +487,8 @@ bool EnqueueCommand(RadioDevice_t *device, Command_t *command)
     if (queue->count >= MAX_COMMAND_QUEUE_CAPACITY)
     {
         /* Queue full */
+        RecordDroppedEnqueue(TELEMETRY_QUEUE_COMMAND);
+
         return false;
     }
 
@@ -344,175 +496,563 @@ bool EnqueueCommand(RadioDevice_t *device, Command_t *command)
     queue->back = (uint8_t)((queue->back + 1) % MAX_COMMAND_QUEUE_CAPACITY);
     queue->count++;
 
+    RecordQueueDepth(TELEMETRY_QUEUE_COMMAND, queue->count);
+
     return true;
 }
 
 /**
- * @brief  Enqueues the given report into the queue
+ * @brief  Enqueues the given command right after the command that is currently
+ *         being processed, ahead of the commands still waiting in the queue
  * @param  device Pointer to the radio device structure
- * @param  command Pointer to the report
+ * @param  command Pointer to the command
  *
- * @retval True if the report was enqueued; false otherwise
+ * @retval True if the command was enqueued; false otherwise
  */
-bool EnqueueReport(RadioDevice_t *device, Report_t *report)
+bool EnqueuePriorityCommand(RadioDevice_t *device, Command_t *command)
 {
-    if (device == NULL || report == NULL)
+    if (device == NULL || command == NULL)
     {
         return false;
     }
 
-    volatile ReportQueue_t *queue = &device->reportQueue;
+    volatile CommandQueue_t *queue = &device->commandQueue;
 
-    if (queue->count >= MAX_REPORT_QUEUE_CAPACITY)
+    // Timer interrupts may enqueue commands as well; keep them out while the queue is shuffled
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (queue->count >= MAX_COMMAND_QUEUE_CAPACITY)
     {
+        __set_PRIMASK(primask);
+
         /* Queue full */
+        RecordDroppedEnqueue(TELEMETRY_QUEUE_COMMAND);
+
         return false;
     }
 
-    queue->reports[queue->back] = *report;
-    queue->back = (uint8_t)((queue->back + 1) % MAX_REPORT_QUEUE_CAPACITY);
+    // A command that has already been sent to the radio must be allowed to finish
+    uint8_t inProgress = (queue->count > 0 && queue->commands[queue->front].state != COMMANDSTATE_IDLE) ? 1 : 0;
+
+    // Move the waiting commands one slot towards the back to make room
+    uint8_t index = queue->back;
+
+    for (uint8_t i = queue->count; i > inProgress; i--)
+    {
+        uint8_t previous = (uint8_t)((index + MAX_COMMAND_QUEUE_CAPACITY - 1) % MAX_COMMAND_QUEUE_CAPACITY);
+
+        queue->commands[index] = queue->commands[previous];
+        index = previous;
+    }
+
+    queue->commands[index] = *command;
+    queue->back = (uint8_t)((queue->back + 1) % MAX_COMMAND_QUEUE_CAPACITY);
     queue->count++;
 
+    RecordQueueDepth(TELEMETRY_QUEUE_COMMAND, queue->count);
+
+    __set_PRIMASK(primask);
+
     return true;
 }
 
-/* External callbacks --------------------------------------------------------*/
-
 /**
- * @brief  Invoked by HAL when a EXTI interrupt has occurred.
- * @param  GPIO_Pin Specifies the port pin connected to corresponding EXTI line.
- * @retval None
+ * @brief  Removes the commands with the given opcode that have not been sent yet;
+ *         the commands of a running macro, and the commands the host passed
+ *         through, are kept, as their completion is waited for
+ * @param  device Pointer to the radio device structure
+ * @param  opCode Opcode of the commands to remove
+ *
+ * @retval Number of commands removed
  */
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+uint8_t RemoveCommands(RadioDevice_t *device, CommandIdentifiers_t opCode)
 {
-    if (GPIO_Pin == RADIO_NIRQ_Pin)
+    if (device == NULL)
     {
-        radioDevice.interruptCounter++;
+        return 0;
     }
-}
 
-/**
- * @brief  Invoked by HAL when I2C Master transmit has completed.
- * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
- *                the configuration information for the specified I2C.
- * @retval None
- */
-void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
-{
-    if (hi2c->Instance == hi2c1.Instance)
+    volatile CommandQueue_t *queue = &device->commandQueue;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Compact the queue in place, keeping the order of the remaining commands
+    uint8_t read = queue->front;
+    uint8_t write = queue->front;
+    uint8_t kept = 0;
+
+    for (uint8_t i = 0; i < queue->count; i++)
     {
-        i2cTransferInterruptRaised = true;
+        volatile Command_t *command = &queue->commands[read];
+
+        if (command->state != COMMANDSTATE_IDLE || command->args.opCode != opCode || command->isMacroCommand ||
+            command->correlationId != 0)
+        {
+            if (write != read)
+            {
+                queue->commands[write] = *command;
+            }
+
+            write = (uint8_t)((write + 1) % MAX_COMMAND_QUEUE_CAPACITY);
+            kept++;
+        }
+
+        read = (uint8_t)((read + 1) % MAX_COMMAND_QUEUE_CAPACITY);
     }
+
+    uint8_t removed = queue->count - kept;
+
+    queue->back = write;
+    queue->count = kept;
+
+    __set_PRIMASK(primask);
+
+    return removed;
 }
 
 /**
- * @brief  Invoked by HAL when I2C Master receive has completed.
- * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
- *                the configuration information for the specified I2C.
- * @retval None
+ * @brief  Cancels the seeks that are waiting in the queue, and the one in
+ *         progress; the latter is cancelled with the CANCEL bit of the
+ *         "Get Tune Status" command, which is sent past the queue
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if there was a seek to cancel; false otherwise
  */
-void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+bool CancelSeek(RadioDevice_t *device)
 {
-    if (hi2c->Instance == hi2c1.Instance)
+    bool isCancelled = RemoveCommands(device, CMD_ID_FM_SEEK_START) > 0;
+
+    Command_t *currentCommand = PeekCommand(&device->commandQueue);
+
+    // Sent when the seek is waiting for STC; the seek then completes as usual. Once STC has been raised the
+    // seek has ended already, and a request left behind would cancel the next seek
+    if (currentCommand != NULL && currentCommand->args.opCode == CMD_ID_FM_SEEK_START &&
+        (currentCommand->state == COMMANDSTATE_SENDING || currentCommand->state == COMMANDSTATE_WAITING_FOR_STC))
     {
-        i2cReceiveInterruptRaised = true;
+        isSeekCancelRequested = true;
+        isCancelled = true;
     }
-}
 
-/**
- * @brief  Invoked by HAL when an I2C transaction encounters an error.
- * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
- *                the configuration information for the specified I2C.
- * @retval None
- */
-void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
-{
-    /* Prevent unused argument(s) compilation warning */
-    UNUSED(hi2c);
+    return isCancelled;
 }
 
 /**
- * @brief  Period elapsed callback in non-blocking mode
- * @param  htim TIM handle
- * @retval None
+ * @brief  Abandons the commands in the queue and the transfer in progress,
+ *         re-initializes the I2C bus and resets the radio; the radio is left
+ *         powered down, for the caller to start again
+ * @param  device Pointer to the radio device structure
  */
-void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+void ResetCommandEngine(RadioDevice_t *device)
 {
-    if (htim->Instance == TIM16)
-    {
-        // Timer 16 is used to periodically query RSQ status when tuned to a station
-        if (radioDevice.currentState != RADIOSTATE_POWERDOWN)
-        {
-            RSQStatus(&radioDevice, FM_RSQ_STATUS_ARGS_NONE);
-        }
-    }
-    else if (htim->Instance == TIM17)
-    {
-        // Timer 17 is used to periodically report device state
-        Report_t report = {0};
+    // Keep the callbacks of an aborted transfer from landing in the state below
+    HAL_NVIC_DisableIRQ(I2C1_IRQn);
+    HAL_NVIC_DisableIRQ(RADIO_NIRQ_EXTI_IRQn);
 
-        report.identifier = REPORT_IDENTIFIER_RADIO_STATUS;
+    HAL_I2C_DeInit(&hi2c1);
+    MX_I2C1_Init();
 
-        report.bytes.radioStatus.currentState = radioDevice.currentState;
-        report.bytes.radioStatus.currentFrequency = radioDevice.currentFrequency;
-        report.bytes.radioStatus.currentVolume = radioDevice.currentVolume;
-        report.bytes.radioStatus.commandQueueCount = radioDevice.commandQueue.count;
-        report.bytes.radioStatus.reportQueueCount = radioDevice.reportQueue.count;
-        report.bytes.radioStatus.isMuted = radioDevice.isMuted;
+    // The commands of a running macro, or of a bulk transfer, are cleared along with the queue
+    AbortMacro(device);
+    AbortPropertyBulk(device);
 
-        EnqueueReport(&radioDevice, &report);
-    }
-}
+    device->commandQueue.count = 0;
+    device->commandQueue.front = 0;
+    device->commandQueue.back = 0;
+    device->pendingInterrupts = 0;
+    device->currentState = RADIOSTATE_POWERDOWN;
 
-/* Private functions ---------------------------------------------------------*/
+    sideCommand.state = COMMANDSTATE_IDLE;
+    i2cTransferInterruptRaised = false;
+    i2cReceiveInterruptRaised = false;
+    isSeekCancelRequested = false;
+    isInterruptRaised = false;
+    isStatusReadInProgress = false;
+    isStatusReceived = false;
+    previousInterruptStatus = 0;
+    commandSettleTick = HAL_GetTick();
 
-/**
- * @brief  Determines if the queue is empty
- * @param  queue Pointer to the queue
- *
- * @retval True if the queue is empty; false otherwise
- */
-bool IsCommandQueueEmpty(CommandQueue_t *queue)
-{
-    if (queue == NULL)
+    HAL_TIM_Base_Stop(&htim16);
+
+    HAL_GPIO_WritePin(RADIO_NRST_GPIO_Port, RADIO_NRST_Pin, GPIO_PIN_RESET);
+
+    uint32_t resetMicroseconds = GetMicroseconds();
+
+    while (GetMicroseconds() - resetMicroseconds < RADIO_RESET_TIME)
     {
-        return true;
     }
 
-    return (queue->count == 0);
+    HAL_GPIO_WritePin(RADIO_NRST_GPIO_Port, RADIO_NRST_Pin, GPIO_PIN_SET);
+
+    HAL_NVIC_EnableIRQ(RADIO_NIRQ_EXTI_IRQn);
+    HAL_NVIC_EnableIRQ(I2C1_IRQn);
 }
 
 /**
- * @brief  Determines if the queue is empty
- * @param  queue Pointer to the queue
+ * @brief  Looks up the descriptor of the given command
+ * @param  opCode Opcode of the command
  *
- * @retval True if the queue is empty; false otherwise
+ * @retval Pointer to the descriptor; an all-zero descriptor for an unknown opcode
  */
-bool IsReportQueueEmpty(ReportQueue_t *queue)
+const CommandDescriptor_t *GetCommandDescriptor(CommandIdentifiers_t opCode)
 {
-    if (queue == NULL)
+    uint8_t slot = COMMAND_DESCRIPTOR_SLOT(opCode);
+
+    // Slot zero has no opcode, and doubles as the descriptor of the unknown ones; the slot folds
+    // the opcode, so an opcode of 0x40 or above may land on the slot of another command
+    if (slot >= COMMAND_DESCRIPTOR_COUNT || commandDescriptors[slot].opCode != (uint8_t)opCode)
     {
-        return true;
+        slot = 0;
     }
 
-    return (queue->count == 0);
+    return &commandDescriptors[slot];
 }
 
 /**
- * @brief  Peeks the first command from the queue without removing it
- * @param  queue Pointer to the queue
+ * @brief  Enqueues the given report into the queue
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the report
  *
- * @retval Pointer to the first command in the queue or NULL if the queue is empty
+ * @retval True if the report was enqueued; false otherwise
  */
-Command_t *PeekCommand(CommandQueue_t *queue)
+bool EnqueueReport(RadioDevice_t *device, Report_t *report)
 {
-    if (queue == NULL || queue->count == 0)
+    if (device == NULL || report == NULL)
     {
-        return NULL;
+        return false;
     }
 
-    return &queue->commands[queue->front];
-}
+    volatile ReportQueue_t *queue = &device->reportQueue;
+
+    // Reports may also be enqueued from an interrupt; keep it out until the slot and the sequence number are taken
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // A report that does not fit still uses up its sequence number, so the host sees the gap
+    uint8_t sequence = reportSequence++;
+
+    if (queue->count >= MAX_REPORT_QUEUE_CAPACITY)
+    {
+        __set_PRIMASK(primask);
+
+        /* Queue full */
+        RecordDroppedEnqueue(TELEMETRY_QUEUE_REPORT);
+
+        return false;
+    }
+
+    queue->reports[queue->back] = *report;
+    WriteReportEnvelope((Report_t *)&queue->reports[queue->back], sequence);
+    queue->back = (uint8_t)((queue->back + 1) % MAX_REPORT_QUEUE_CAPACITY);
+    queue->count++;
+
+    uint8_t count = queue->count;
+
+    __set_PRIMASK(primask);
+
+    RecordQueueDepth(TELEMETRY_QUEUE_REPORT, count);
+
+    return true;
+}
+
+/**
+ * @brief  Fills in the radio status report from the current device state
+ * @param  device Pointer to the radio device structure
+ * @param  report Pointer to the zeroed report to fill in
+ */
+void BuildRadioStatusReport(RadioDevice_t *device, Report_t *report)
+{
+    report->identifier = REPORT_IDENTIFIER_RADIO_STATUS;
+
+    report->bytes.radioStatus.currentState = device->currentState;
+    report->bytes.radioStatus.currentFrequency = device->currentFrequency;
+    report->bytes.radioStatus.currentVolume = device->currentVolume;
+    report->bytes.radioStatus.commandQueueCount = device->commandQueue.count;
+    report->bytes.radioStatus.reportQueueCount = device->reportQueue.count;
+    report->bytes.radioStatus.isMuted = device->isMuted;
+}
+
+/**
+ * @brief  Enqueues a radio status report when the state, frequency, volume or
+ *         mute has changed since the previous one, or when the heartbeat is due
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportRadioStatus(RadioDevice_t *device)
+{
+    uint32_t now = HAL_GetTick();
+
+    bool isChanged = !isRadioStatusReported || device->currentState != reportedRadioStatus.currentState ||
+                     device->currentFrequency != reportedRadioStatus.currentFrequency ||
+                     device->currentVolume != reportedRadioStatus.currentVolume ||
+                     device->isMuted != reportedRadioStatus.isMuted;
+    bool isDue = radioStatusHeartbeat != 0 && (int32_t)(now - nextRadioStatusTick) >= 0;
+
+    if (!isChanged && !isDue)
+    {
+        return false;
+    }
+
+    // Held back until there is room, so that the change is not lost along with the report
+    if (!tud_mounted() || device->reportQueue.count >= MAX_REPORT_QUEUE_CAPACITY)
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    BuildRadioStatusReport(device, &report);
+
+    // A report enqueued from an interrupt may have taken the last slot since the check above
+    if (!EnqueueReport(device, &report))
+    {
+        return false;
+    }
+
+    reportedRadioStatus = report.bytes.radioStatus;
+    isRadioStatusReported = true;
+    nextRadioStatusTick = now + radioStatusHeartbeat;
+
+    return true;
+}
+
+/**
+ * @brief  Sets the interval of the radio status heartbeat, and reports the
+ *         status right away
+ * @param  request Pointer to the request
+ */
+void ConfigureRadioStatusHeartbeat(const RadioStatusHeartbeatRequest_t *request)
+{
+    radioStatusHeartbeat = request->interval;
+
+    if (radioStatusHeartbeat != 0 && radioStatusHeartbeat < RADIO_STATUS_HEARTBEAT_MIN)
+    {
+        radioStatusHeartbeat = RADIO_STATUS_HEARTBEAT_MIN;
+    }
+
+    isRadioStatusReported = false;
+}
+
+/**
+ * @brief  Enqueues the interrupt servicing counters as a new report once timer
+ *         17 has marked the window due and the IN endpoint is free, and starts
+ *         a new report window once the report has been enqueued
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportInterruptStatistics(RadioDevice_t *device)
+{
+    if (!isInterruptStatisticsDue || !tud_hid_ready())
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_INTERRUPT_STATISTICS;
+
+    InterruptStatisticsReport_t *statistics = &report.bytes.interruptStatistics;
+
+    statistics->wakeups = interruptStatistics.wakeups;
+    statistics->spuriousWakeups = interruptStatistics.spuriousWakeups;
+
+    for (uint8_t i = 0; i < INTERRUPT_SOURCE_COUNT; i++)
+    {
+        statistics->counts[i] = interruptStatistics.counts[i];
+        statistics->spuriousCounts[i] = interruptStatistics.spuriousCounts[i];
+        statistics->maximumLatency[i] = interruptStatistics.maximumLatency[i];
+
+        if (interruptStatistics.counts[i] > 0)
+        {
+            statistics->averageLatency[i] =
+                (uint16_t)(interruptStatistics.totalLatency[i] / interruptStatistics.counts[i]);
+        }
+    }
+
+    // The counters keep running into the window that was due, until it has been reported
+    if (!EnqueueReport(device, &report))
+    {
+        return false;
+    }
+
+    interruptStatistics = (InterruptStatistics_t){0};
+    isInterruptStatisticsDue = false;
+
+    return true;
+}
+
+/**
+ * @brief  Stamps the envelope of a report that is read as a snapshot rather
+ *         than sent through the queue; it carries the sequence number of the
+ *         next queued report without using it up
+ * @param  report Pointer to the report
+ */
+void StampSnapshot(Report_t *report)
+{
+    WriteReportEnvelope(report, reportSequence);
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/**
+ * @brief  Invoked by HAL when a EXTI interrupt has occurred.
+ * @param  GPIO_Pin Specifies the port pin connected to corresponding EXTI line.
+ * @retval None
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin == RADIO_NIRQ_Pin)
+    {
+        // The status read that follows covers every edge until then; the first one is timed
+        if (!isInterruptRaised)
+        {
+            interruptMicroseconds = GetMicroseconds();
+            isInterruptRaised = true;
+        }
+    }
+}
+
+/**
+ * @brief  Invoked by HAL when I2C Master transmit has completed.
+ * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+ *                the configuration information for the specified I2C.
+ * @retval None
+ */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c->Instance == hi2c1.Instance)
+    {
+        RecordI2CTransferComplete();
+
+        i2cTransferInterruptRaised = true;
+    }
+}
+
+/**
+ * @brief  Invoked by HAL when I2C Master receive has completed.
+ * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+ *                the configuration information for the specified I2C.
+ * @retval None
+ */
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c->Instance == hi2c1.Instance)
+    {
+        RecordI2CTransferComplete();
+
+        if (isStatusReadInProgress)
+        {
+            isStatusReceived = true;
+        }
+        else
+        {
+            i2cReceiveInterruptRaised = true;
+        }
+    }
+}
+
+/**
+ * @brief  Invoked by HAL when an I2C transaction encounters an error.
+ * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+ *                the configuration information for the specified I2C.
+ * @retval None
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c->Instance == hi2c1.Instance)
+    {
+        RecordI2CTransferComplete();
+
+        // A failed status read is retried; the edges it was to cover are raised again,
+        // timed from the first of them
+        if (isStatusReadInProgress)
+        {
+            isStatusReadInProgress = false;
+
+            interruptMicroseconds = wakeupMicroseconds;
+            isInterruptRaised = true;
+        }
+    }
+}
+
+/**
+ * @brief  Period elapsed callback in non-blocking mode
+ * @param  htim TIM handle
+ * @retval None
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM16)
+    {
+        // Timer 16 is used to periodically query RSQ and AGC status when tuned to a station
+        if (radioDevice.currentState != RADIOSTATE_POWERDOWN)
+        {
+            AGCStatus(&radioDevice);
+            RSQStatus(&radioDevice, FM_RSQ_STATUS_ARGS_NONE);
+        }
+    }
+    else if (htim->Instance == TIM17)
+    {
+        // Timer 17 is used to mark the audio pipeline and interrupt servicing counters due for reporting;
+        // those and the radio status are reported from the main loop
+        MarkAudioStatisticsDue();
+
+        isInterruptStatisticsDue = true;
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Determines if the queue is empty
+ * @param  queue Pointer to the queue
+ *
+ * @retval True if the queue is empty; false otherwise
+ */
+bool IsCommandQueueEmpty(CommandQueue_t *queue)
+{
+    if (queue == NULL)
+    {
+        return true;
+    }
+
+    return (queue->count == 0);
+}
+
+/**
+ * @brief  Determines if the queue is empty
+ * @param  queue Pointer to the queue
+ *
+ * @retval True if the queue is empty; false otherwise
+ */
+bool IsReportQueueEmpty(ReportQueue_t *queue)
+{
+    if (queue == NULL)
+    {
+        return true;
+    }
+
+    return (queue->count == 0);
+}
+
+/**
+ * @brief  Peeks the first command from the queue without removing it
+ * @param  queue Pointer to the queue
+ *
+ * @retval Pointer to the first command in the queue or NULL if the queue is empty
+ */
+Command_t *PeekCommand(CommandQueue_t *queue)
+{
+    if (queue == NULL || queue->count == 0)
+    {
+        return NULL;
+    }
+
+    return &queue->commands[queue->front];
+}
 
 /**
  * @brief  Pops the first command from the queue, removing it
@@ -536,22 +1076,608 @@ Command_t *PopCommand(CommandQueue_t *queue)
 }
 
 /**
- * @brief  Pops the first report from the queue, removing it
- * @param  queue Pointer to the queue
+ * @brief  Determines if a command with the given opcode is in the queue
+ * @param  device Pointer to the radio device structure
+ * @param  opCode Opcode of the command
  *
- * @retval Pointer to the first report in the queue or NULL if the queue is empty
+ * @retval True if the command is in the queue; false otherwise
  */
-Report_t *PopReport(ReportQueue_t *queue)
+bool IsCommandQueued(RadioDevice_t *device, CommandIdentifiers_t opCode)
 {
-    if (queue == NULL || queue->count == 0)
+    volatile CommandQueue_t *queue = &device->commandQueue;
+
+    uint8_t index = queue->front;
+
+    for (uint8_t i = 0; i < queue->count; i++)
     {
-        return NULL;
+        if (queue->commands[index].args.opCode == opCode)
+        {
+            return true;
+        }
+
+        index = (uint8_t)((index + 1) % MAX_COMMAND_QUEUE_CAPACITY);
     }
 
-    Report_t *report = &queue->reports[queue->front];
-    const uint8_t capacity = (uint8_t)(sizeof(queue->reports) / sizeof(queue->reports[0]));
-    queue->front = (uint8_t)((queue->front + 1) % capacity);
-    queue->count--;
+    return false;
+}
+
+/**
+ * @brief  Determines if an I2C transfer of the front command or the side command is in progress
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the bus is busy; false otherwise
+ */
+bool IsBusBusy(RadioDevice_t *device)
+{
+    if (sideCommand.state == COMMANDSTATE_SENDING || sideCommand.state == COMMANDSTATE_RECEIVING_RESPONSE)
+    {
+        return true;
+    }
+
+    Command_t *currentCommand = PeekCommand(&device->commandQueue);
+
+    return currentCommand != NULL &&
+           (currentCommand->state == COMMANDSTATE_SENDING || currentCommand->state == COMMANDSTATE_RECEIVING_RESPONSE);
+}
+
+/**
+ * @brief  Sends a "Get Tune Status" command past the queue while the front
+ *         command is waiting for STC
+ * @param  device Pointer to the radio device structure
+ * @param  args Arguments to the command; INTACK must not be used, as the front
+ *         command relies on the STC interrupt
+ *
+ * @retval True if the command was sent; false otherwise
+ */
+bool StartSideCommand(RadioDevice_t *device, CMD_GET_TUNE_STATUS_ARGS args)
+{
+    const CommandDescriptor_t *descriptor = GetCommandDescriptor(CMD_ID_FM_TUNE_STATUS);
+
+    sideCommand.args.opCode = CMD_ID_FM_TUNE_STATUS;
+    sideCommand.args.bytes[1] = args & (uint8_t)~GET_TUNE_STATUS_ARGS_INTACK;
+    sideCommand.argLength = descriptor->argLength;
+    sideCommand.responseLength = descriptor->responseLength;
+    sideCommand.state = COMMANDSTATE_SENDING;
+
+    ClearInterrupts(device, SI4705_STATUS_CTS | SI4705_STATUS_ERR);
+
+    RecordI2CTransferStart();
+
+    HAL_StatusTypeDef status = HAL_I2C_Master_Transmit_IT(&hi2c1, device->deviceAddress,
+                                                          (uint8_t *)&sideCommand.args, sideCommand.argLength);
+
+    if (status != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Advances the side command, and reports the seek progress once the
+ *         response has been received
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True, as the side command holds the bus until it completes
+ */
+bool ProcessSideCommand(RadioDevice_t *device)
+{
+    if (sideCommand.state == COMMANDSTATE_SENDING && i2cTransferInterruptRaised)
+    {
+        i2cTransferInterruptRaised = false;
+
+        sideCommand.state = COMMANDSTATE_WAITING_FOR_CTS;
+    }
+    else if (sideCommand.state == COMMANDSTATE_WAITING_FOR_CTS && (device->pendingInterrupts & SI4705_STATUS_CTS))
+    {
+        // An STC of the seek read along with this CTS stays pending for the seek
+        device->pendingInterrupts &= (uint8_t)~(SI4705_STATUS_CTS | SI4705_STATUS_ERR);
+
+        sideCommand.state = COMMANDSTATE_RECEIVING_RESPONSE;
+
+        RecordI2CTransferStart();
+
+        HAL_StatusTypeDef status = HAL_I2C_Master_Receive_IT(
+            &hi2c1, device->deviceAddress, (uint8_t *)&sideCommand.response, sideCommand.responseLength);
+
+        if (status != HAL_OK)
+        {
+            Error_Handler();
+        }
+    }
+    else if (sideCommand.state == COMMANDSTATE_RECEIVING_RESPONSE && i2cReceiveInterruptRaised)
+    {
+        i2cReceiveInterruptRaised = false;
+
+        // Without CTS the response was read too early, and is not valid
+        if (sideCommand.response[0] & 0x80)
+        {
+            ProcessSeekProgress(device, (Command_t *)&sideCommand);
+        }
+
+        sideCommand.state = COMMANDSTATE_IDLE;
+
+        // A seek takes seconds, but the progress polls keep completing along the way
+        CheckIn(SUBSYSTEM_COMMAND_ENGINE);
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Reads the status byte once the interrupt line has been raised and
+ *         the bus is free, and services the sources it shows
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the status read holds the bus; false otherwise
+ */
+bool ProcessInterrupts(RadioDevice_t *device)
+{
+    if (isStatusReadInProgress)
+    {
+        if (!isStatusReceived)
+        {
+            return true;
+        }
+
+        isStatusReceived = false;
+        isStatusReadInProgress = false;
+
+        ServiceInterrupts(device, interruptStatus, wakeupMicroseconds);
+
+        return true;
+    }
+
+    if (!isInterruptRaised || IsBusBusy(device))
+    {
+        return false;
+    }
+
+    // The edges raised from now on are covered by the next read
+    wakeupMicroseconds = interruptMicroseconds;
+    isInterruptRaised = false;
+    isStatusReadInProgress = true;
+
+    IncrementCounter(&interruptStatistics.wakeups);
+
+    RecordI2CTransferStart();
+
+    // The status byte can be read at any time, even while a command is being processed
+    HAL_StatusTypeDef status = HAL_I2C_Master_Receive_IT(&hi2c1, device->deviceAddress, &interruptStatus, 1);
+
+    if (status != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Fans the status byte read after an interrupt out to the sources:
+ *         CTS, STC and ERR are left pending for the command state machine,
+ *         while RDS and RSQ schedule the retrieval of their data
+ * @param  device Pointer to the radio device structure
+ * @param  status Status byte read after the interrupt
+ * @param  edgeMicroseconds Time of the interrupt edge, in µs
+ */
+void ServiceInterrupts(RadioDevice_t *device, uint8_t status, uint32_t edgeMicroseconds)
+{
+    uint8_t raised = status & (uint8_t)~previousInterruptStatus & SI4705_STATUS_SOURCES;
+    uint8_t unexpected = 0;
+
+    previousInterruptStatus = status;
+
+    Command_t *currentCommand = PeekCommand(&device->commandQueue);
+
+    bool isCommandInFlight = sideCommand.state == COMMANDSTATE_SENDING ||
+                             sideCommand.state == COMMANDSTATE_WAITING_FOR_CTS ||
+                             (currentCommand != NULL && currentCommand->state >= COMMANDSTATE_SENDING &&
+                              currentCommand->state <= COMMANDSTATE_WAITING_FOR_STC);
+
+    bool isTuneInFlight = currentCommand != NULL && currentCommand->state >= COMMANDSTATE_SENDING &&
+                          currentCommand->state <= COMMANDSTATE_WAITING_FOR_STC &&
+                          GetCommandDescriptor(currentCommand->args.opCode)->wait == COMMANDWAIT_STC;
+
+    // These are levels until the next command clears them, so a later read may set them again
+    device->pendingInterrupts |= status & (SI4705_STATUS_CTS | SI4705_STATUS_ERR | SI4705_STATUS_STCINT);
+
+    if (!isCommandInFlight)
+    {
+        unexpected |= SI4705_STATUS_CTS | SI4705_STATUS_ERR;
+    }
+
+    if (!isTuneInFlight)
+    {
+        unexpected |= SI4705_STATUS_STCINT;
+    }
+
+    // RDS and RSQ stay raised until acknowledged; one retrieval at a time is enough
+    if (status & SI4705_STATUS_RDSINT)
+    {
+        if (IsCommandQueued(device, CMD_ID_FM_RDS_STATUS))
+        {
+            unexpected |= SI4705_STATUS_RDSINT;
+        }
+        else
+        {
+            RDSStatus(device, FM_RDS_STATUS_ARGS_INTACK);
+        }
+    }
+
+    if (status & SI4705_STATUS_RSQINT)
+    {
+        if (IsCommandQueued(device, CMD_ID_FM_RSQ_STATUS))
+        {
+            unexpected |= SI4705_STATUS_RSQINT;
+        }
+        else
+        {
+            RSQStatus(device, FM_RSQ_STATUS_ARGS_INTACK);
+        }
+    }
+
+    if (raised == 0)
+    {
+        IncrementCounter(&interruptStatistics.spuriousWakeups);
+
+        return;
+    }
+
+    uint32_t latency = GetMicroseconds() - edgeMicroseconds;
+
+    if (latency > UINT16_MAX)
+    {
+        latency = UINT16_MAX;
+    }
+
+    for (uint8_t i = 0; i < INTERRUPT_SOURCE_COUNT; i++)
+    {
+        if (!(raised & interruptSources[i]))
+        {
+            continue;
+        }
+
+        IncrementCounter(&interruptStatistics.counts[i]);
+
+        if (unexpected & interruptSources[i])
+        {
+            IncrementCounter(&interruptStatistics.spuriousCounts[i]);
+        }
+
+        interruptStatistics.totalLatency[i] += latency;
+
+        if (latency > interruptStatistics.maximumLatency[i])
+        {
+            interruptStatistics.maximumLatency[i] = (uint16_t)latency;
+        }
+    }
+}
+
+/**
+ * @brief  Forgets the given interrupt sources, once a command has cleared them in the radio
+ * @param  device Pointer to the radio device structure
+ * @param  sources Status byte bits of the sources
+ */
+void ClearInterrupts(RadioDevice_t *device, uint8_t sources)
+{
+    device->pendingInterrupts &= (uint8_t)~sources;
+    previousInterruptStatus &= (uint8_t)~sources;
+}
+
+/**
+ * @brief  Increments the counter, unless it is already at its maximum value
+ * @param  counter Pointer to the counter
+ */
+void IncrementCounter(uint16_t *counter)
+{
+    if (*counter < UINT16_MAX)
+    {
+        (*counter)++;
+    }
+}
+
+/**
+ * @brief  Writes the envelope after the struct bytes of the report
+ * @param  report Pointer to the report
+ * @param  sequence Sequence number the envelope carries
+ */
+void WriteReportEnvelope(Report_t *report, uint8_t sequence)
+{
+    ReportEnvelope_t envelope = {
+        .timestamp = GetMicroseconds(),
+        .frame = (uint16_t)(USB->FNR & USB_FNR_FN),
+        .sequence = sequence,
+    };
+
+    memcpy(&report->bytes.raw[REPORT_ENVELOPE_OFFSET], &envelope, REPORT_ENVELOPE_SIZE);
+}
+
+/**
+ * @brief  Completes the "Power up" command
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the command always completes
+ */
+bool CompletePowerUp(RadioDevice_t *device, Command_t *command)
+{
+    // The "QueryLibraryId" variant leaves the radio powered down
+    if (command->responseLength == 0)
+    {
+        device->currentState = RADIOSTATE_POWERUP;
+
+        // Every property is back at its default
+        ClearPropertyShadow();
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Completes the "Power down" command
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the command always completes
+ */
+bool CompletePowerDown(RadioDevice_t *device, Command_t *command)
+{
+    UNUSED(command);
+
+    device->currentState = RADIOSTATE_POWERDOWN;
+
+    HAL_TIM_Base_Stop(&htim16);
+
+    return true;
+}
+
+/**
+ * @brief  Completes the "Set Property" command, and updates the device state
+ *         that follows the property
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the command always completes
+ */
+bool CompleteSetProperty(RadioDevice_t *device, Command_t *command)
+{
+    PropertyIdentifiers_t property =
+        (PropertyIdentifiers_t)((command->args.bytes[2] << 8) | (command->args.bytes[3] << 0));
+
+    uint16_t value = (uint16_t)((command->args.bytes[4] << 8) | (command->args.bytes[5] << 0));
+
+    WritePropertyShadow(property, value);
+
+    if (property == PROP_ID_DIGITAL_OUTPUT_SAMPLE_RATE)
+    {
+        if (value != 0)
+        {
+            device->currentState = RADIOSTATE_DIGITAL_OUTPUT_ENABLED;
+
+            RecordBootMilestone(BOOT_MILESTONE_RADIO_READY);
+        }
+        else
+        {
+            device->currentState = RADIOSTATE_TUNED_TO_STATION;
+        }
+    }
+    else if (property == PROP_ID_RX_VOLUME)
+    {
+        device->currentVolume = value;
+    }
+    else if (property == PROP_ID_RX_HARD_MUTE)
+    {
+        if (value == 0)
+        {
+            device->isMuted = false;
+        }
+        else if (value & 0b11)
+        {
+            device->isMuted = true;
+        }
+
+        // Per-channel mute status is not supported
+    }
+    else if (property == PROP_ID_FM_DEEMPHASIS)
+    {
+        device->currentDeemphasis = (uint8_t)value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Completes the "Get Int Status" command; reports the status, and
+ *         retrieves the RDS data when it is available
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the status was reported; false otherwise
+ */
+bool CompleteIntStatus(RadioDevice_t *device, Command_t *command)
+{
+    bool isReported = ProcessIntStatus(device, command);
+
+    // bool clearToSend = command->response[0] & 0x80;
+    // bool error = command->response[0] & 0x40;
+    // bool rsqInterrupt = command->response[0] & 0x08;
+    bool rdsInterrupt = command->response[0] & 0x04;
+    // bool seekTuneCompleted = command->response[0] & 0x01;
+
+    if (rdsInterrupt && !IsCommandQueued(device, CMD_ID_FM_RDS_STATUS))
+    {
+        RDSStatus(device, FM_RDS_STATUS_ARGS_INTACK);
+    }
+
+    return isReported;
+}
+
+/**
+ * @brief  Completes the "FM Tune" and "Seek Start" commands
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the command always completes
+ */
+bool CompleteTune(RadioDevice_t *device, Command_t *command)
+{
+    UNUSED(command);
+
+    device->currentState = RADIOSTATE_TUNED_TO_STATION;
+
+    // Schedule a GetTuneStatus to update the current frequency reading and clear the STCINT bit;
+    // its response is also reported to the host as the first signal quality reading
+    TuneStatus(device, GET_TUNE_STATUS_ARGS_INTACK);
+
+    // A scan only needs the tune status of each channel; audio, RSQ
+    // polling and RDS resume when the scan returns to the station
+    if (!IsScanning())
+    {
+        // Re-phase the RSQ polling so that the periodic readings follow on from the one below
+        __HAL_TIM_SET_COUNTER(&htim16, 0);
+        __HAL_TIM_CLEAR_FLAG(&htim16, TIM_FLAG_UPDATE);
+
+        HAL_TIM_Base_Start_IT(&htim16);
+
+        // After tuning or seek has completed, set the sample rate so the chip begins sending audio samples
+        SetProperty(device, PROP_ID_DIGITAL_OUTPUT_SAMPLE_RATE, CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE);
+
+        // Take a fresh RSQ reading right away instead of waiting for the timer
+        AGCStatus(device);
+        RSQStatus(device, FM_RSQ_STATUS_ARGS_NONE);
+
+        // Reset the RDS parser state
+        RDSReset();
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Completes the "Get Tune Status" command, and updates the current
+ *         frequency reading
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the command always completes
+ */
+bool CompleteTuneStatus(RadioDevice_t *device, Command_t *command)
+{
+    // Channels measured by an AF check are not the current station at all; the check reads the
+    // tune status again if it switches to one
+    if (ProcessAlternativeFrequencyTuneStatus(device, command))
+    {
+        return true;
+    }
+
+    // Channels measured by a scan are not reported as the current station
+    if (!ProcessScanTuneStatus(device, command))
+    {
+        ProcessTuneStatus(device, command);
+    }
+
+    // If the channel is valid, update the frequency reading; otherwise reset it to zero
+    if (command->response[1] & 0x01)
+    {
+        device->currentFrequency = (uint16_t)((command->response[2] << 8) | (command->response[3] << 0));
+        device->currentAntennaCapacitor = command->response[7];
+
+        // Remember the value, so the next tune to this channel can skip the automatic search
+        CacheAntennaCapacitor(device->currentFrequency, device->currentAntennaCapacitor);
+    }
+    else
+    {
+        device->currentFrequency = 0;
+        device->currentAntennaCapacitor = 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Completes the "FM RSQ Status" command
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the reading was reported; false otherwise
+ */
+bool CompleteRSQStatus(RadioDevice_t *device, Command_t *command)
+{
+    bool isReported = ProcessRSQStatus(device, command);
+
+    if (command->args.bytes[1] & FM_RSQ_STATUS_ARGS_INTACK)
+    {
+        ClearInterrupts(device, SI4705_STATUS_RSQINT);
+    }
+
+    ProcessAlternativeFrequencyRSQ(device, command);
+
+    return isReported;
+}
+
+/**
+ * @brief  Completes the "FM RDS Status" command, and passes the RDS data on to the parser
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True, as the command always completes
+ */
+bool CompleteRDSStatus(RadioDevice_t *device, Command_t *command)
+{
+    uint8_t fifoCount = command->response[3];
+
+    if (command->args.bytes[1] & FM_RDS_STATUS_ARGS_INTACK)
+    {
+        ClearInterrupts(device, SI4705_STATUS_RDSINT);
+    }
+
+    uint16_t blockA = (uint16_t)((command->response[4] << 8) | (command->response[5] << 0));
+    uint16_t blockB = (uint16_t)((command->response[6] << 8) | (command->response[7] << 0));
+    uint16_t blockC = (uint16_t)((command->response[8] << 8) | (command->response[9] << 0));
+    uint16_t blockD = (uint16_t)((command->response[10] << 8) | (command->response[11] << 0));
+
+    uint8_t blockAErrors = command->response[12] & 0xC0;
+    uint8_t blockBErrors = command->response[12] & 0x30;
+    uint8_t blockCErrors = command->response[12] & 0x0C;
+    uint8_t blockDErrors = command->response[12] & 0x03;
+
+    ProcessRDSData(blockA, blockB, blockC, blockD, blockAErrors, blockBErrors, blockCErrors, blockDErrors);
+
+    if (fifoCount > 0)
+    {
+        // Schedule a new retrieval until the FIFO is empty
+        RDSStatus(device, FM_RDS_STATUS_ARGS_NONE);
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Pops the first report from the queue, removing it
+ * @param  queue Pointer to the queue
+ *
+ * @retval Pointer to the first report in the queue or NULL if the queue is empty
+ */
+Report_t *PopReport(ReportQueue_t *queue)
+{
+    if (queue == NULL || queue->count == 0)
+    {
+        return NULL;
+    }
+
+    Report_t *report = &queue->reports[queue->front];
+    const uint8_t capacity = (uint8_t)(sizeof(queue->reports) / sizeof(queue->reports[0]));
+    queue->front = (uint8_t)((queue->front + 1) % capacity);
+
+    // An interrupt may enqueue a report in between the read and the write of the count
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    queue->count--;
+
+    __set_PRIMASK(primask);
 
     return report;
 }
@@ -75,6 +75,15 @@ typedef struct _Command_t
 
     /* Number of expected response bytes */
     uint8_t responseLength;
+
+    /* Correlation identifier of a command the host passed through; zero for the commands of the firmware */
+    uint8_t correlationId;
+
+    /* Set when the command is a part of the command macro that is running */
+    bool isMacroCommand;
+
+    /* Position plus one of the property a bulk transfer enqueued the command for; zero for the other commands */
+    uint8_t bulkIndex;
 } Command_t;
 
 #define MAX_COMMAND_QUEUE_CAPACITY 20
@@ -125,12 +134,28 @@ typedef struct _RadioDevice_t
     /* Holds the current volume level of the device */
     uint8_t currentVolume;
 
-    /* Holds the number of times the interrupt line has triggered */
-    uint8_t interruptCounter;
+    /* Holds the interrupt sources read from the status byte that are waiting to be serviced */
+    uint8_t pendingInterrupts;
 
     /* Holds the mute status of the device */
     bool isMuted;
 
+    /* Holds the FM de-emphasis setting of the device */
+    uint8_t currentDeemphasis;
+
+    /* Holds the antenna tuning capacitor value of the current station */
+    uint8_t currentAntennaCapacitor;
+
+    /* Holds whether the RF AGC has been disabled, and the LNA gain index in use */
+    bool isAGCDisabled;
+    uint8_t lnaGainIndex;
+
+    /* Holds the time from sending the last tune or seek to its STC interrupt, in µs */
+    uint32_t lastTuneDuration;
+
+    /* Holds the tick at which the oscillator has started up; no commands are sent before that */
+    uint32_t oscillatorReadyTick;
+
     /* Holds the command queue */
     CommandQueue_t commandQueue;
 
@@ -138,6 +163,36 @@ typedef struct _RadioDevice_t
     ReportQueue_t reportQueue;
 } RadioDevice_t;
 
+typedef enum _CommandWait_t : uint8_t
+{
+    /* The command completes with the CTS interrupt */
+    COMMANDWAIT_CTS = 0x00,
+
+    /* The command completes with the STC interrupt, followed by the CTS interrupt */
+    COMMANDWAIT_STC = 0x01,
+} CommandWait_t;
+
+typedef struct _CommandDescriptor_t
+{
+    /* Opcode the descriptor belongs to; other opcodes that fold into the same slot are unknown */
+    uint8_t opCode;
+
+    /* Number of arguments, including the opcode */
+    uint8_t argLength;
+
+    /* Number of expected response bytes */
+    uint8_t responseLength;
+
+    /* Interrupt the command waits for once it has been sent */
+    CommandWait_t wait;
+
+    /* Time the radio needs after the command has completed before the next command, in ms */
+    uint8_t settleTime;
+
+    /* Processes the response and updates the device state once the command has completed; may be NULL */
+    bool (*complete)(RadioDevice_t *device, Command_t *command);
+} CommandDescriptor_t;
+
 /* Exported constants --------------------------------------------------------*/
 
 // Hard-coded addresses recognized by the Si4705 device, left-shifted for HAL-compatibility
@@ -152,6 +207,19 @@ typedef struct _RadioDevice_t
 #define SI4705_REFCLK_PRESCALE_MIN_SETTING 1
 #define SI4705_REFCLK_PRESCALE_MAX_SETTING 4095
 
+// Maximum antenna tuning capacitor value; zero selects the value automatically
+#define SI4705_ANTCAP_MAX_SETTING 191
+
+// Maximum LNA gain index, which is the maximum attenuation
+#define SI4705_LNA_GAIN_INDEX_MAX_SETTING 26
+
+// Interrupt sources in the status byte, which is the first byte of every response
+#define SI4705_STATUS_CTS 0x80
+#define SI4705_STATUS_ERR 0x40
+#define SI4705_STATUS_RSQINT 0x08
+#define SI4705_STATUS_RDSINT 0x04
+#define SI4705_STATUS_STCINT 0x01
+
 /* Exported macros -----------------------------------------------------------*/
 
 /* Exported variables --------------------------------------------------------*/
@@ -159,9 +227,19 @@ extern RadioDevice_t radioDevice;
 
 /* Exported functions --------------------------------------------------------*/
 extern bool EnqueueCommand(RadioDevice_t *device, Command_t *command);
+extern bool EnqueuePriorityCommand(RadioDevice_t *device, Command_t *command);
+extern uint8_t RemoveCommands(RadioDevice_t *device, CommandIdentifiers_t opCode);
+extern bool CancelSeek(RadioDevice_t *device);
+extern void ResetCommandEngine(RadioDevice_t *device);
 extern bool ProcessCommand(RadioDevice_t *device);
+extern const CommandDescriptor_t *GetCommandDescriptor(CommandIdentifiers_t opCode);
 extern bool EnqueueReport(RadioDevice_t *device, Report_t *report);
 extern bool ProcessReport(RadioDevice_t *device);
+extern void BuildRadioStatusReport(RadioDevice_t *device, Report_t *report);
+extern bool ReportRadioStatus(RadioDevice_t *device);
+extern bool ReportInterruptStatistics(RadioDevice_t *device);
+extern void ConfigureRadioStatusHeartbeat(const RadioStatusHeartbeatRequest_t *request);
+extern void StampSnapshot(Report_t *report);
 
 #ifdef __cplusplus
 }
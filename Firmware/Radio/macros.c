@@ -0,0 +1,301 @@
+/**
+ ******************************************************************************
+ * @file    macros.c
+ * @brief   Implements the command macros; sequences of commands that are
+ *          queued at once, and reported once when the last one completes
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "macros.h"
+#include "commands.h"
+#include "common.h"
+#include "properties.h"
+#include "stm32f0xx_hal.h"
+#include "telemetry.h"
+#include "tim.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _Macro_t
+{
+    /* Number of commands in the macro; zero marks an empty slot */
+    uint8_t count;
+
+    /* Commands of the macro, in the order they are sent */
+    MacroRecord_t records[MACRO_RECORD_COUNT];
+} Macro_t;
+
+typedef struct _MacroExecution_t
+{
+    /* Set from queueing the macro until its last command has completed */
+    bool isRunning;
+
+    /* Identifier of the macro */
+    uint8_t macroId;
+
+    /* Number of commands in the macro, and of those that have completed */
+    uint8_t commandCount;
+    uint8_t completedCount;
+
+    /* Index and status byte of the first command the radio rejected */
+    uint8_t failedIndex;
+    uint8_t failedStatus;
+
+    /* Time at which the macro was queued, in µs */
+    uint32_t startMicroseconds;
+} MacroExecution_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private macros ------------------------------------------------------------*/
+
+// Builds the record of a "Set Property" command
+#define MACRO_SET_PROPERTY(property, value)                                                                            \
+    {                                                                                                                  \
+        CMD_ID_SET_PROPERTY, 5,                                                                                        \
+        {                                                                                                              \
+            0x00, (uint8_t)((property) >> 8), (uint8_t)((property) & 0xFF), (uint8_t)((value) >> 8),                   \
+                (uint8_t)((value) & 0xFF)                                                                              \
+        }                                                                                                              \
+    }
+
+// clang-format off
+// Powers up the radio, and configures its interrupts, GPO pins and RDS; the
+// station and the audio settings are left for the caller to apply
+const MacroRecord_t bootMacro[] = {
+    // Power up the radio
+    { CMD_ID_POWER_UP, 2, { POWER_UP_ARGS_1_FUNCTION_FM | POWER_UP_ARGS_1_GPO2_OUTPUT_ENABLE | POWER_UP_ARGS_1_CTS_INTERRUPT_ENABLE,
+                            POWER_UP_ARGS_2_DIGITAL_OUTPUT_2 } },
+
+    // Enable other interrupt sources
+    MACRO_SET_PROPERTY(PROP_ID_GPO_IEN, GPO_IEN_ARGS_CTSIEN | GPO_IEN_ARGS_STCIEN | GPO_IEN_ARGS_RDSIEN | GPO_IEN_ARGS_ERRIEN),
+
+    // Allow GPO output, and drive GPO1 and GPO3 low to reduce oscillation
+    { CMD_ID_GPIO_CTL, 1, { GPIO_CTL_GPO1_OUTPUT_ENABLE | GPIO_CTL_GPO3_OUTPUT_ENABLE } },
+    { CMD_ID_GPIO_SET, 1, { GPIO_SET_GPO2_OUTPUT_HIGH } },
+
+    // Configure RDS to raise interrupt when buffers are full, after ten groups, and enable RDS processing
+    MACRO_SET_PROPERTY(PROP_ID_FM_RDS_INT_SOURCE, FM_RDS_INT_SOURCE_ARGS_RDSRECV),
+    MACRO_SET_PROPERTY(PROP_ID_FM_RDS_INT_FIFO_COUNT, 10),
+    MACRO_SET_PROPERTY(PROP_ID_FM_RDS_CONFIG, FM_RDS_CONFIG_ARGS_RDS_ENABLE),
+};
+// clang-format on
+
+/* Private variables ---------------------------------------------------------*/
+
+// Macros stored by the host; lost on reset
+Macro_t macros[MACRO_SLOT_COUNT] = {0};
+
+// Macro that is running; only one runs at a time
+MacroExecution_t macroExecution = {0};
+
+/* Private function prototypes -----------------------------------------------*/
+bool ReportMacroCompletion(RadioDevice_t *device, uint8_t macroId, MacroResult_t result);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Stores a macro in one of the macro slots, replacing the one there
+ * @param  request Pointer to the request
+ *
+ * @retval True if the macro was stored; false if the slot or a command was out of range
+ */
+bool StoreMacro(const MacroStoreRequest_t *request)
+{
+    if (request->macroId >= MACRO_SLOT_COUNT || request->count > MACRO_RECORD_COUNT)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < request->count; i++)
+    {
+        if (request->records[i].argLength > sizeof(request->records[i].args))
+        {
+            return false;
+        }
+    }
+
+    // A running macro was copied into the command queue already, so its slot can be replaced
+    Macro_t *macro = &macros[request->macroId];
+
+    macro->count = request->count;
+    memcpy(macro->records, request->records, request->count * sizeof(MacroRecord_t));
+
+    return true;
+}
+
+/**
+ * @brief  Queues every command of the macro at once, so that no other command
+ *         is queued between them; a macro that cannot run is reported right away
+ * @param  device Pointer to the radio device structure
+ * @param  macroId Slot of a stored macro, or MACRO_ID_BOOT
+ *
+ * @retval True if the macro was queued; false otherwise
+ */
+bool RunMacro(RadioDevice_t *device, uint8_t macroId)
+{
+    const MacroRecord_t *records = NULL;
+    uint8_t count = 0;
+
+    if (macroId == MACRO_ID_BOOT)
+    {
+        records = bootMacro;
+        count = sizeof(bootMacro) / sizeof(bootMacro[0]);
+    }
+    else if (macroId < MACRO_SLOT_COUNT)
+    {
+        records = macros[macroId].records;
+        count = macros[macroId].count;
+    }
+
+    if (count == 0)
+    {
+        ReportMacroCompletion(device, macroId, MACRO_RESULT_EMPTY);
+
+        return false;
+    }
+
+    if (macroExecution.isRunning)
+    {
+        ReportMacroCompletion(device, macroId, MACRO_RESULT_BUSY);
+
+        return false;
+    }
+
+    // Timer interrupts may enqueue commands as well; keep them out until the whole macro is in
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (MAX_COMMAND_QUEUE_CAPACITY - device->commandQueue.count < count)
+    {
+        __set_PRIMASK(primask);
+
+        RecordDroppedEnqueue(TELEMETRY_QUEUE_COMMAND);
+        ReportMacroCompletion(device, macroId, MACRO_RESULT_QUEUE_FULL);
+
+        return false;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const CommandDescriptor_t *descriptor = GetCommandDescriptor((CommandIdentifiers_t)records[i].opCode);
+
+        Command_t command = {0};
+
+        command.args.bytes[0] = records[i].opCode;
+        memcpy(&command.args.bytes[1], records[i].args, records[i].argLength);
+        command.argLength = (uint8_t)(records[i].argLength + 1);
+        command.responseLength = descriptor->responseLength;
+        command.isMacroCommand = true;
+
+        EnqueueCommand(device, &command);
+    }
+
+    macroExecution.isRunning = true;
+    macroExecution.macroId = macroId;
+    macroExecution.commandCount = count;
+    macroExecution.completedCount = 0;
+    macroExecution.failedIndex = MACRO_INDEX_NONE;
+    macroExecution.failedStatus = 0;
+    macroExecution.startMicroseconds = GetMicroseconds();
+
+    __set_PRIMASK(primask);
+
+    return true;
+}
+
+/**
+ * @brief  Counts a completed command of the running macro, and reports the
+ *         macro once its last command has completed
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @remark The commands after a rejected one still run, as they are already
+ *         in the queue; the report names the first one that was rejected
+ */
+void CompleteMacroCommand(RadioDevice_t *device, Command_t *command)
+{
+    if (!macroExecution.isRunning)
+    {
+        return;
+    }
+
+    if ((command->response[0] & SI4705_STATUS_ERR) && macroExecution.failedIndex == MACRO_INDEX_NONE)
+    {
+        macroExecution.failedIndex = macroExecution.completedCount;
+        macroExecution.failedStatus = command->response[0];
+    }
+
+    if (++macroExecution.completedCount < macroExecution.commandCount)
+    {
+        return;
+    }
+
+    macroExecution.isRunning = false;
+
+    ReportMacroCompletion(device, macroExecution.macroId,
+                          macroExecution.failedIndex == MACRO_INDEX_NONE ? MACRO_RESULT_COMPLETED
+                                                                         : MACRO_RESULT_FAILED);
+}
+
+/**
+ * @brief  Reports the running macro as aborted; invoked when the command
+ *         engine is restarted and its queue is cleared
+ * @param  device Pointer to the radio device structure
+ */
+void AbortMacro(RadioDevice_t *device)
+{
+    if (!macroExecution.isRunning)
+    {
+        return;
+    }
+
+    macroExecution.isRunning = false;
+
+    ReportMacroCompletion(device, macroExecution.macroId, MACRO_RESULT_ABORTED);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Enqueues the outcome of a macro as a new report
+ * @param  device Pointer to the radio device structure
+ * @param  macroId Identifier of the macro
+ * @param  result Outcome of the macro
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportMacroCompletion(RadioDevice_t *device, uint8_t macroId, MacroResult_t result)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_MACRO_COMPLETION;
+
+    report.bytes.macroCompletion.macroId = macroId;
+    report.bytes.macroCompletion.result = result;
+    report.bytes.macroCompletion.failedIndex = MACRO_INDEX_NONE;
+
+    // Only a macro that was queued has commands to account for
+    if (result == MACRO_RESULT_COMPLETED || result == MACRO_RESULT_FAILED || result == MACRO_RESULT_ABORTED)
+    {
+        report.bytes.macroCompletion.duration = GetMicroseconds() - macroExecution.startMicroseconds;
+        report.bytes.macroCompletion.commandCount = macroExecution.commandCount;
+        report.bytes.macroCompletion.completedCount = macroExecution.completedCount;
+        report.bytes.macroCompletion.failedIndex = macroExecution.failedIndex;
+        report.bytes.macroCompletion.failedStatus = macroExecution.failedStatus;
+    }
+
+    return EnqueueReport(device, &report);
+}
@@ -0,0 +1,49 @@
+/**
+ ******************************************************************************
+ * @file    macros.h
+ * @brief   Header for macros.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __MACROS_H__
+#define __MACROS_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern bool StoreMacro(const MacroStoreRequest_t *request);
+extern bool RunMacro(RadioDevice_t *device, uint8_t macroId);
+extern void CompleteMacroCommand(RadioDevice_t *device, Command_t *command);
+extern void AbortMacro(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __MACROS_H__ */
@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file    passthrough.c
+ * @brief   Implements the commands the host passes through to the radio as
+ *          they are, and the reports that return their responses
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "passthrough.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+bool ReportPassthroughRejection(RadioDevice_t *device, const PassthroughRequest_t *request,
+                                PassthroughResult_t result);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Enqueues a command the host has passed through, behind the commands
+ *         of the firmware; a command that cannot be queued is reported back
+ *         right away
+ * @param  device Pointer to the radio device structure
+ * @param  request Pointer to the request
+ *
+ * @retval True if the command was enqueued; false otherwise
+ *
+ * @remark A known opcode still waits for the interrupt, settles and updates
+ *         the device state as its descriptor says; an unknown one completes
+ *         with CTS
+ */
+bool EnqueuePassthroughCommand(RadioDevice_t *device, const PassthroughRequest_t *request)
+{
+    Command_t command = {0};
+
+    if (request->correlationId == 0 || request->argLength > sizeof(request->args) ||
+        request->responseLength > sizeof(command.response))
+    {
+        ReportPassthroughRejection(device, request, PASSTHROUGH_RESULT_INVALID);
+
+        return false;
+    }
+
+    const CommandDescriptor_t *descriptor = GetCommandDescriptor((CommandIdentifiers_t)request->opCode);
+
+    command.args.bytes[0] = request->opCode;
+    memcpy(&command.args.bytes[1], request->args, request->argLength);
+    command.argLength = (uint8_t)(request->argLength + 1);
+
+    // The completion handler of a known opcode reads the whole response
+    command.responseLength = request->responseLength > descriptor->responseLength ? request->responseLength
+                                                                                   : descriptor->responseLength;
+    command.correlationId = request->correlationId;
+
+    if (!EnqueueCommand(device, &command))
+    {
+        ReportPassthroughRejection(device, request, PASSTHROUGH_RESULT_QUEUE_FULL);
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Enqueues the response of a completed passthrough command as a new report
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ * @param  duration Time from sending the command to its completion, in µs
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportPassthroughResponse(RadioDevice_t *device, Command_t *command, uint32_t duration)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_PASSTHROUGH_RESPONSE;
+
+    report.bytes.passthroughResponse.duration = duration;
+    report.bytes.passthroughResponse.correlationId = command->correlationId;
+    report.bytes.passthroughResponse.opCode = command->args.bytes[0];
+    report.bytes.passthroughResponse.result = PASSTHROUGH_RESULT_COMPLETED;
+
+    // Without a response to read, the engine keeps the status byte as the response
+    report.bytes.passthroughResponse.responseLength = command->responseLength > 0 ? command->responseLength : 1;
+    memcpy(report.bytes.passthroughResponse.response, command->response,
+           report.bytes.passthroughResponse.responseLength);
+
+    return EnqueueReport(device, &report);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Enqueues a report of a passthrough command that was not sent
+ * @param  device Pointer to the radio device structure
+ * @param  request Pointer to the request
+ * @param  result Reason the command was not sent
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportPassthroughRejection(RadioDevice_t *device, const PassthroughRequest_t *request,
+                                PassthroughResult_t result)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_PASSTHROUGH_RESPONSE;
+
+    report.bytes.passthroughResponse.correlationId = request->correlationId;
+    report.bytes.passthroughResponse.opCode = request->opCode;
+    report.bytes.passthroughResponse.result = result;
+
+    return EnqueueReport(device, &report);
+}
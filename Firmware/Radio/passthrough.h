@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file    passthrough.h
+ * @brief   Header for passthrough.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __PASSTHROUGH_H__
+#define __PASSTHROUGH_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern bool EnqueuePassthroughCommand(RadioDevice_t *device, const PassthroughRequest_t *request);
+extern bool ReportPassthroughResponse(RadioDevice_t *device, Command_t *command, uint32_t duration);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PASSTHROUGH_H__ */
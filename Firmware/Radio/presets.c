@@ -0,0 +1,260 @@
+/**
+ ******************************************************************************
+ * @file    presets.c
+ * @brief   Implements the station presets kept in the flash storage
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "presets.h"
+#include "commands.h"
+#include "rds.h"
+#include "storage.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+
+// Offsets of the preset fields from the first key of the preset
+typedef enum _PresetField_t : uint8_t
+{
+    PRESET_FIELD_FREQUENCY = 0,
+    PRESET_FIELD_PROGRAMME_IDENTIFICATION = 1,
+    PRESET_FIELD_PROGRAMME_SERVICE = 2,
+    PRESET_FIELD_ANTENNA_CAPACITOR = 6,
+} PresetField_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+// Number of storage keys reserved for each preset
+#define PRESET_KEY_COUNT 8
+
+// The programme service is stored as two characters per key
+#define PRESET_PROGRAMME_SERVICE_KEYS (sizeof(((Preset_t *)0)->programmeService) / 2)
+
+static_assert(STORAGE_KEY_PRESET_FIRST + PRESET_COUNT * PRESET_KEY_COUNT - 1 <= STORAGE_KEY_PRESET_LAST);
+
+// The slots waiting to be written are tracked in a byte
+static_assert(PRESET_COUNT <= 8);
+
+/* Private macros ------------------------------------------------------------*/
+#define PRESET_KEY(index, field) ((StorageKey_t)(STORAGE_KEY_PRESET_FIRST + (index) * PRESET_KEY_COUNT + (field)))
+
+/* Private variables ---------------------------------------------------------*/
+
+// Presets waiting to be written into the storage, and a bit mask of their slots
+Preset_t pendingPresets[PRESET_COUNT] = {0};
+uint8_t pendingPresetMask = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+bool WritePreset(uint8_t index, const Preset_t *preset);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Reads a preset from the storage
+ * @param  index Slot of the preset
+ * @param  preset Pointer to where the preset is stored
+ *
+ * @retval True if the slot holds a preset; false otherwise
+ */
+bool ReadPreset(uint8_t index, Preset_t *preset)
+{
+    memset(preset, 0, sizeof(Preset_t));
+
+    if (index >= PRESET_COUNT || !StorageRead(PRESET_KEY(index, PRESET_FIELD_FREQUENCY), &preset->frequency) ||
+        preset->frequency == 0)
+    {
+        preset->frequency = 0;
+
+        return false;
+    }
+
+    uint16_t value = 0;
+
+    StorageRead(PRESET_KEY(index, PRESET_FIELD_PROGRAMME_IDENTIFICATION), &preset->programmeIdentification);
+
+    for (uint8_t i = 0; i < PRESET_PROGRAMME_SERVICE_KEYS; i++)
+    {
+        value = 0x2020; // Two spaces
+
+        StorageRead(PRESET_KEY(index, PRESET_FIELD_PROGRAMME_SERVICE + i), &value);
+
+        preset->programmeService[i * 2 + 0] = (char)(value >> 8);
+        preset->programmeService[i * 2 + 1] = (char)(value >> 0);
+    }
+
+    value = 0;
+
+    StorageRead(PRESET_KEY(index, PRESET_FIELD_ANTENNA_CAPACITOR), &value);
+
+    preset->antennaCapacitor = (uint8_t)value;
+
+    return true;
+}
+
+/**
+ * @brief  Captures a preset to be stored; the storage is written from the
+ *         main loop once the command queue is idle, after which the updated
+ *         preset list is enqueued as a report
+ * @param  device Pointer to the radio device structure
+ * @param  index Slot of the preset
+ * @param  frequency Frequency of the station, in 10 kHz increments; zero stores the
+ *         current station along with its RDS identity and antenna tuning capacitor value
+ *
+ * @retval True if the preset will be stored; false otherwise
+ */
+bool StorePreset(RadioDevice_t *device, uint8_t index, uint16_t frequency)
+{
+    if (index >= PRESET_COUNT)
+    {
+        return false;
+    }
+
+    Preset_t preset = {0};
+
+    memset(preset.programmeService, ' ', sizeof(preset.programmeService));
+
+    if (frequency == 0)
+    {
+        if (device->currentFrequency == 0)
+        {
+            // Not tuned to a valid station
+            return false;
+        }
+
+        preset.frequency = device->currentFrequency;
+        preset.programmeIdentification = RDSGetProgrammeIdentification();
+        preset.antennaCapacitor = device->currentAntennaCapacitor;
+
+        RDSGetProgrammeService(preset.programmeService);
+    }
+    else
+    {
+        preset.frequency = frequency;
+    }
+
+    // A later store to the same slot replaces the one still waiting
+    pendingPresets[index] = preset;
+    pendingPresetMask |= (uint8_t)(1U << index);
+
+    return true;
+}
+
+/**
+ * @brief  Writes one of the presets waiting to be stored into the storage, and
+ *         reports the preset list once all of them have been written; invoked
+ *         from the main loop
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a preset was written; false otherwise
+ */
+bool ProcessPresets(RadioDevice_t *device)
+{
+    // A preset takes up to eight flash writes, and the CPU stalls on each of them; one slot is
+    // written per round, and only while no command is waiting on the radio
+    if (pendingPresetMask == 0 || device->commandQueue.count > 0)
+    {
+        return false;
+    }
+
+    uint8_t index = 0;
+
+    while (!(pendingPresetMask & (1U << index)))
+    {
+        index++;
+    }
+
+    bool isWritten = WritePreset(index, &pendingPresets[index]);
+
+    // A slot that could not be written is dropped; the preset list shows what the storage holds
+    pendingPresetMask &= (uint8_t)~(1U << index);
+
+    if (pendingPresetMask == 0)
+    {
+        ReportPresets(device);
+    }
+
+    return isWritten;
+}
+
+/**
+ * @brief  Tunes to a preset; the tune is placed ahead of the commands waiting
+ *         in the queue, and uses the cached antenna tuning capacitor value
+ * @param  device Pointer to the radio device structure
+ * @param  index Slot of the preset
+ *
+ * @retval True if the tune was enqueued; false otherwise
+ */
+bool RecallPreset(RadioDevice_t *device, uint8_t index)
+{
+    Preset_t preset;
+
+    // The tune goes ahead of the queue, so it must not overtake the power-up at boot or after a restart
+    if (device->currentState == RADIOSTATE_POWERDOWN || !ReadPreset(index, &preset))
+    {
+        return false;
+    }
+
+    return PriorityTuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, preset.frequency, preset.antennaCapacitor);
+}
+
+/**
+ * @brief  Enqueues the list of presets as a new report
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportPresets(RadioDevice_t *device)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_PRESET_LIST;
+    report.bytes.presetList.count = PRESET_COUNT;
+
+    for (uint8_t i = 0; i < PRESET_COUNT; i++)
+    {
+        ReadPreset(i, &report.bytes.presetList.presets[i]);
+    }
+
+    return EnqueueReport(device, &report);
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Writes a preset into the storage
+ * @param  index Slot of the preset
+ * @param  preset Pointer to the preset
+ *
+ * @retval True if the preset was written; false otherwise
+ */
+bool WritePreset(uint8_t index, const Preset_t *preset)
+{
+    bool isStored = StorageWrite(PRESET_KEY(index, PRESET_FIELD_PROGRAMME_IDENTIFICATION),
+                                 preset->programmeIdentification) &&
+                    StorageWrite(PRESET_KEY(index, PRESET_FIELD_ANTENNA_CAPACITOR), preset->antennaCapacitor);
+
+    for (uint8_t i = 0; isStored && i < PRESET_PROGRAMME_SERVICE_KEYS; i++)
+    {
+        uint16_t value = (uint16_t)(((uint8_t)preset->programmeService[i * 2 + 0] << 8) |
+                                    ((uint8_t)preset->programmeService[i * 2 + 1] << 0));
+
+        isStored = StorageWrite(PRESET_KEY(index, PRESET_FIELD_PROGRAMME_SERVICE + i), value);
+    }
+
+    // The frequency is written last; it marks the preset as valid
+    return isStored && StorageWrite(PRESET_KEY(index, PRESET_FIELD_FREQUENCY), preset->frequency);
+}
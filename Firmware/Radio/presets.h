@@ -0,0 +1,50 @@
+/**
+ ******************************************************************************
+ * @file    presets.h
+ * @brief   Header for presets.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __PRESETS_H__
+#define __PRESETS_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern bool ReadPreset(uint8_t index, Preset_t *preset);
+extern bool StorePreset(RadioDevice_t *device, uint8_t index, uint16_t frequency);
+extern bool ProcessPresets(RadioDevice_t *device);
+extern bool RecallPreset(RadioDevice_t *device, uint8_t index);
+extern bool ReportPresets(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PRESETS_H__ */
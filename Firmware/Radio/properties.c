@@ -1,7 +1,9 @@
 /**
  ******************************************************************************
  * @file    properties.c
- * @brief   Implements property wrapper calls; it is intentionally empty
+ * @brief   Implements the shadow copy of the radio properties, and the bulk
+ *          transfers of properties requested by the host; the property
+ *          wrapper calls themselves are inline in properties.h
  ******************************************************************************
  * @attention
  *
@@ -15,21 +17,405 @@
  */
 
 /* Includes ------------------------------------------------------------------*/
+#include "properties.h"
+#include "main.h"
+#include <string.h>
 
 /* Global variables ----------------------------------------------------------*/
 
 /* Private types -------------------------------------------------------------*/
+typedef struct _PropertyShadow_t
+{
+    /* Identifier of the property */
+    PropertyIdentifiers_t property;
+
+    /* Value the radio holds for the property */
+    uint16_t value;
+} PropertyShadow_t;
+
+typedef struct _PropertyBulk_t
+{
+    /* Set while a bulk transfer is in progress */
+    bool isActive;
+
+    /* Number of properties whose commands have been enqueued, or which have been answered */
+    uint8_t enqueuedCount;
+
+    /* Bit mask of the properties whose commands the radio has yet to complete, indexed by their position */
+    uint32_t pendingMask;
+
+    /* Results reported once every property has been handled */
+    PropertyBulkReport_t results;
+} PropertyBulk_t;
 
 /* Private constants ---------------------------------------------------------*/
 
+// Number of properties in the shadow; more than the firmware ever sets or reads
+#define PROPERTY_SHADOW_SIZE 20
+
+// Command queue entries a bulk transfer leaves free for RSQ, RDS and host commands
+#define PROPERTY_BULK_QUEUE_HEADROOM 4
+
 /* Private macros ------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
+PropertyShadow_t propertyShadow[PROPERTY_SHADOW_SIZE] = {0};
+
+uint8_t propertyShadowCount = 0;
+
+PropertyBulk_t propertyBulk = {.isActive = false};
 
 /* Private function prototypes -----------------------------------------------*/
+bool FindPendingProperty(RadioDevice_t *device, PropertyIdentifiers_t property, uint16_t *value);
+bool EnqueuePropertyBulkCommand(RadioDevice_t *device, uint8_t index);
+bool ReportPropertyBulk(RadioDevice_t *device);
 
 /* Exported functions --------------------------------------------------------*/
 
+/**
+ * @brief  Gets the value the radio will hold for the given property once the
+ *         queued commands have been sent
+ * @param  device Pointer to the radio device structure
+ * @param  property Identifier of the property
+ * @param  value Pointer to where the value is stored
+ *
+ * @retval True if the value is known; false if it has to be read from the radio
+ */
+bool ReadPropertyShadow(RadioDevice_t *device, PropertyIdentifiers_t property, uint16_t *value)
+{
+    // A queued "Set Property" overrides the value the radio holds now
+    if (FindPendingProperty(device, property, value))
+    {
+        return true;
+    }
+
+    for (uint8_t i = 0; i < propertyShadowCount; i++)
+    {
+        if (propertyShadow[i].property == property)
+        {
+            *value = propertyShadow[i].value;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief  Records the value the radio holds for the given property; called when
+ *         a "Set Property" or a "Get Property" command completes
+ * @param  property Identifier of the property
+ * @param  value Value of the property
+ */
+void WritePropertyShadow(PropertyIdentifiers_t property, uint16_t value)
+{
+    for (uint8_t i = 0; i < propertyShadowCount; i++)
+    {
+        if (propertyShadow[i].property == property)
+        {
+            propertyShadow[i].value = value;
+
+            return;
+        }
+    }
+
+    // When the shadow is full, the property is just read from the radio every time
+    if (propertyShadowCount < PROPERTY_SHADOW_SIZE)
+    {
+        propertyShadow[propertyShadowCount].property = property;
+        propertyShadow[propertyShadowCount].value = value;
+
+        propertyShadowCount++;
+    }
+}
+
+/**
+ * @brief  Forgets every property; the radio resets them to their defaults on power up
+ */
+void ClearPropertyShadow(void)
+{
+    propertyShadowCount = 0;
+}
+
+/**
+ * @brief  Checks if setting the given property has an effect even when the
+ *         value does not change
+ * @param  property Identifier of the property
+ *
+ * @retval True if the property must always be written to the radio; false otherwise
+ */
+bool IsPropertyAlwaysWritten(PropertyIdentifiers_t property)
+{
+    // The digital audio output is restarted by setting the sample rate after every tune
+    return property == PROP_ID_DIGITAL_OUTPUT_SAMPLE_RATE;
+}
+
+/**
+ * @brief  Starts a bulk set or get of the properties in the request; the
+ *         commands are pipelined through the command queue, and a single
+ *         report lists the results once every property has been handled
+ * @param  device Pointer to the radio device structure
+ * @param  request Pointer to the request
+ * @param  isSet True to set the properties; false to get them
+ *
+ * @retval True if the transfer was started; false if the request was rejected
+ */
+bool StartPropertyBulk(RadioDevice_t *device, const PropertyBulkRequest_t *request, bool isSet)
+{
+    uint8_t count = request->count > PROPERTY_BULK_COUNT ? PROPERTY_BULK_COUNT : request->count;
+
+    if (propertyBulk.isActive)
+    {
+        // One transfer at a time; every property of this one is reported as failed
+        Report_t report = {0};
+
+        report.identifier = REPORT_IDENTIFIER_PROPERTY_BULK_RESULT;
+
+        report.bytes.propertyBulk.sequence = request->sequence;
+        report.bytes.propertyBulk.count = count;
+        report.bytes.propertyBulk.isSet = isSet;
+        report.bytes.propertyBulk.failedCount = count;
+        report.bytes.propertyBulk.failedMask = count == 32 ? UINT32_MAX : (1UL << count) - 1;
+
+        memcpy(report.bytes.propertyBulk.properties, request->properties, count * sizeof(PropertyValue_t));
+
+        EnqueueReport(device, &report);
+
+        return false;
+    }
+
+    memset(&propertyBulk, 0, sizeof(PropertyBulk_t));
+
+    propertyBulk.results.sequence = request->sequence;
+    propertyBulk.results.count = count;
+    propertyBulk.results.isSet = isSet;
+
+    memcpy(propertyBulk.results.properties, request->properties, count * sizeof(PropertyValue_t));
+
+    propertyBulk.isActive = true;
+
+    ProcessPropertyBulk(device);
+
+    return true;
+}
+
+/**
+ * @brief  Enqueues the commands of the bulk transfer as the command queue
+ *         has room for them; called from the main loop
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a bulk transfer is in progress; false otherwise
+ */
+bool ProcessPropertyBulk(RadioDevice_t *device)
+{
+    if (!propertyBulk.isActive)
+    {
+        return false;
+    }
+
+    PropertyBulkReport_t *results = &propertyBulk.results;
+
+    while (propertyBulk.enqueuedCount < results->count &&
+           device->commandQueue.count < MAX_COMMAND_QUEUE_CAPACITY - PROPERTY_BULK_QUEUE_HEADROOM)
+    {
+        uint8_t index = propertyBulk.enqueuedCount++;
+
+        if (!EnqueuePropertyBulkCommand(device, index))
+        {
+            results->failedMask |= 1UL << index;
+            results->failedCount++;
+        }
+    }
+
+    // Reported once the radio has completed the command of every property
+    if (propertyBulk.enqueuedCount >= results->count && propertyBulk.pendingMask == 0)
+    {
+        if (ReportPropertyBulk(device))
+        {
+            propertyBulk.isActive = false;
+        }
+    }
+
+    return propertyBulk.isActive;
+}
+
+/**
+ * @brief  Records the outcome of a command enqueued by the bulk transfer; called
+ *         when the command completes, whether the radio accepted it or not
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the command belonged to the bulk transfer; false otherwise
+ */
+bool ProcessPropertyBulkResponse(RadioDevice_t *device, Command_t *command)
+{
+    (void)device;
+
+    if (!propertyBulk.isActive || command->bulkIndex == 0)
+    {
+        return false;
+    }
+
+    uint8_t index = command->bulkIndex - 1;
+
+    if (!(propertyBulk.pendingMask & (1UL << index)))
+    {
+        return false;
+    }
+
+    propertyBulk.pendingMask &= ~(1UL << index);
+
+    if (command->response[0] & SI4705_STATUS_ERR)
+    {
+        propertyBulk.results.failedMask |= 1UL << index;
+        propertyBulk.results.failedCount++;
+    }
+    else if (!propertyBulk.results.isSet)
+    {
+        propertyBulk.results.properties[index].value = (uint16_t)((command->response[2] << 8) | command->response[3]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Fails the properties of the bulk transfer that have not been
+ *         completed; invoked when the command engine is restarted and its
+ *         queue is cleared
+ * @param  device Pointer to the radio device structure
+ */
+void AbortPropertyBulk(RadioDevice_t *device)
+{
+    (void)device;
+
+    if (!propertyBulk.isActive)
+    {
+        return;
+    }
+
+    PropertyBulkReport_t *results = &propertyBulk.results;
+
+    for (uint8_t i = 0; i < results->count; i++)
+    {
+        if (i >= propertyBulk.enqueuedCount || (propertyBulk.pendingMask & (1UL << i)))
+        {
+            results->failedMask |= 1UL << i;
+            results->failedCount++;
+        }
+    }
+
+    // The results are reported from the main loop
+    propertyBulk.enqueuedCount = results->count;
+    propertyBulk.pendingMask = 0;
+}
+
 /* External callbacks --------------------------------------------------------*/
 
 /* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Finds the value of the last queued "Set Property" command for the given property
+ * @param  device Pointer to the radio device structure
+ * @param  property Identifier of the property
+ * @param  value Pointer to where the value is stored
+ *
+ * @retval True if such a command is in the queue; false otherwise
+ */
+bool FindPendingProperty(RadioDevice_t *device, PropertyIdentifiers_t property, uint16_t *value)
+{
+    CommandQueue_t *queue = &device->commandQueue;
+
+    bool isFound = false;
+
+    for (uint8_t i = 0; i < queue->count; i++)
+    {
+        Command_t *command = &queue->commands[(queue->front + i) % MAX_COMMAND_QUEUE_CAPACITY];
+
+        if (command->args.opCode == CMD_ID_SET_PROPERTY &&
+            (PropertyIdentifiers_t)((command->args.bytes[2] << 8) | command->args.bytes[3]) == property)
+        {
+            *value = (uint16_t)((command->args.bytes[4] << 8) | command->args.bytes[5]);
+
+            isFound = true;
+        }
+    }
+
+    return isFound;
+}
+
+/**
+ * @brief  Enqueues the command of the given property of the bulk transfer,
+ *         tagged with its position; a property whose value is already known
+ *         is handled right away without the command
+ * @param  device Pointer to the radio device structure
+ * @param  index Position of the property in the bulk transfer
+ *
+ * @retval True if the command was enqueued or the property handled; false otherwise
+ */
+bool EnqueuePropertyBulkCommand(RadioDevice_t *device, uint8_t index)
+{
+    PropertyValue_t *entry = &propertyBulk.results.properties[index];
+
+    PropertyIdentifiers_t property = (PropertyIdentifiers_t)entry->property;
+
+    CommandIdentifiers_t opCode = propertyBulk.results.isSet ? CMD_ID_SET_PROPERTY : CMD_ID_GET_PROPERTY;
+
+    uint16_t currentValue;
+
+    if (ReadPropertyShadow(device, property, &currentValue))
+    {
+        if (!propertyBulk.results.isSet)
+        {
+            entry->value = currentValue;
+
+            return true;
+        }
+
+        // As in SetProperty(), an unchanged value is not written again
+        if (!IsPropertyAlwaysWritten(property) && currentValue == entry->value)
+        {
+            return true;
+        }
+    }
+
+    const CommandDescriptor_t *descriptor = GetCommandDescriptor(opCode);
+
+    Command_t command = {0};
+
+    command.args.opCode = opCode;
+    command.args.bytes[1] = 0x00;
+    command.args.bytes[2] = (uint8_t)((property & 0xFF00) >> 8);
+    command.args.bytes[3] = (uint8_t)((property & 0x00FF) >> 0);
+    command.args.bytes[4] = (uint8_t)((entry->value & 0xFF00) >> 8);
+    command.args.bytes[5] = (uint8_t)((entry->value & 0x00FF) >> 0);
+    command.argLength = descriptor->argLength;
+    command.responseLength = descriptor->responseLength;
+    command.bulkIndex = (uint8_t)(index + 1);
+
+    if (!EnqueueCommand(device, &command))
+    {
+        return false;
+    }
+
+    propertyBulk.pendingMask |= 1UL << index;
+
+    return true;
+}
+
+/**
+ * @brief  Enqueues the results of the bulk transfer as a new report
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportPropertyBulk(RadioDevice_t *device)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_PROPERTY_BULK_RESULT;
+
+    memcpy(&report.bytes.propertyBulk, &propertyBulk.results, sizeof(PropertyBulkReport_t));
+
+    return EnqueueReport(device, &report);
+}
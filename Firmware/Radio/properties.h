@@ -24,6 +24,7 @@ extern "C"
 #endif /* __cplusplus */
 
 /* Includes ------------------------------------------------------------------*/
+#include "commands.h"
 #include "device.h"
 
 /* Exported types */
@@ -178,6 +179,14 @@ typedef enum _PROP_FM_RDS_CONFIG_ARGS : uint16_t
 /* Exported variables --------------------------------------------------------*/
 
 /* Exported functions --------------------------------------------------------*/
+extern bool ReadPropertyShadow(RadioDevice_t *device, PropertyIdentifiers_t property, uint16_t *value);
+extern void WritePropertyShadow(PropertyIdentifiers_t property, uint16_t value);
+extern void ClearPropertyShadow(void);
+extern bool IsPropertyAlwaysWritten(PropertyIdentifiers_t property);
+extern bool StartPropertyBulk(RadioDevice_t *device, const PropertyBulkRequest_t *request, bool isSet);
+extern bool ProcessPropertyBulk(RadioDevice_t *device);
+extern bool ProcessPropertyBulkResponse(RadioDevice_t *device, Command_t *command);
+extern void AbortPropertyBulk(RadioDevice_t *device);
 
 /**
  * @brief  Enqueues the "SET PROPERTY" command with "GPO_IEN" to configure which
@@ -17,6 +17,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "rds.h"
+#include "af.h"
 #include "device.h"
 #include "reports.h"
 #include <string.h>
@@ -31,6 +32,7 @@ rdsparser_t rdsParser;
 /* Private macros ------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
+rdsparser_rt_flag_t radioTextFlag = {0};
 
 /* Private function prototypes -----------------------------------------------*/
 void callback_ps(rdsparser_t *rds, bool, void *user_data);
@@ -81,6 +83,8 @@ void ProcessRDSData(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t
 {
     rdsparser_parse(&rdsParser, (rdsparser_data_t){blockA, blockB, blockC, blockD},
                     (rdsparser_error_t){blockAErrors, blockBErrors, blockCErrors, blockDErrors});
+
+    ProcessAlternativeFrequencyGroup(blockA, blockB, blockC, blockAErrors, blockBErrors, blockCErrors);
 }
 
 /**
@@ -91,6 +95,45 @@ void RDSReset()
     rdsparser_clear(&rdsParser);
 }
 
+/**
+ * @brief  Gets the Programme Identification (PI) code of the current station
+ *
+ * @retval PI code; zero if it has not been received yet
+ */
+uint16_t RDSGetProgrammeIdentification()
+{
+    int32_t pi = rdsparser_get_pi(&rdsParser);
+
+    return pi < 0 ? 0 : (uint16_t)pi;
+}
+
+/**
+ * @brief  Copies the Programme Service (PS) name of the current station
+ * @param  programmeService Pointer to a buffer of eight characters; padded with spaces
+ */
+void RDSGetProgrammeService(char *programmeService)
+{
+    const rdsparser_string_t *ps = rdsparser_get_ps(&rdsParser);
+    const rdsparser_string_char_t *ps_content = rdsparser_string_get_content(ps);
+    uint8_t length = rdsparser_string_get_length(ps);
+
+    memset(programmeService, ' ', 8);
+    memcpy(programmeService, ps_content, length > 8 ? 8 : length);
+}
+
+/**
+ * @brief  Copies the most recently received Radio Text (RT) of the current station
+ * @param  radioText Pointer to a buffer of 64 characters; unused characters are left untouched
+ */
+void RDSGetRadioText(char *radioText)
+{
+    const rdsparser_string_t *rt = rdsparser_get_rt(&rdsParser, radioTextFlag);
+    const rdsparser_string_char_t *rt_content = rdsparser_string_get_content(rt);
+    uint8_t length = rdsparser_string_get_length(rt);
+
+    memcpy(radioText, rt_content, length > 64 ? 64 : length);
+}
+
 /* External callbacks --------------------------------------------------------*/
 
 /* Private functions ---------------------------------------------------------*/
@@ -134,6 +177,8 @@ void callback_rt(rdsparser_t *rds, rdsparser_rt_flag_t flag, bool changed, void
         return;
     }
 
+    radioTextFlag = flag;
+
     const rdsparser_string_t *rt = rdsparser_get_rt(rds, flag);
     const rdsparser_string_char_t *rt_content = rdsparser_string_get_content(rt);
     const uint8_t length = rdsparser_string_get_length(rt);
@@ -38,6 +38,9 @@ extern rdsparser_t rdsParser;
 /* Exported functions --------------------------------------------------------*/
 extern bool RDSInit();
 extern void RDSReset();
+extern uint16_t RDSGetProgrammeIdentification();
+extern void RDSGetProgrammeService(char *programmeService);
+extern void RDSGetRadioText(char *radioText);
 extern void ProcessRDSData(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t blockD, uint8_t blockAErrors,
                            uint8_t blockBErrors, uint8_t blockCErrors, uint8_t blockDErrors);
 
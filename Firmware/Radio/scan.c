@@ -0,0 +1,408 @@
+/**
+ ******************************************************************************
+ * @file    scan.c
+ * @brief   Implements the band scan, which steps through every channel of
+ *          the seek band and streams the signal metrics to the host
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scan.h"
+#include "commands.h"
+#include "main.h"
+#include "tim.h"
+#include "tusb.h"
+#include <string.h>
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef enum _ScanState_t : uint8_t
+{
+    /* No scan is in progress */
+    SCAN_STATE_IDLE = 0x00,
+
+    /* Waiting for the band limits and the channel spacing */
+    SCAN_STATE_READING_BAND = 0x01,
+
+    /* Waiting for the tune and the tune status of the current channel */
+    SCAN_STATE_MEASURING = 0x02,
+
+    /* The current channel has been measured */
+    SCAN_STATE_MEASURED = 0x03,
+
+    /* Every channel has been measured; the results are being flushed */
+    SCAN_STATE_FINISHING = 0x04,
+} ScanState_t;
+
+typedef struct _Scan_t
+{
+    /* Current state of the scan */
+    ScanState_t state;
+
+    /* Set when the host has asked to stop the scan */
+    bool isStopRequested;
+
+    /* Band limits and the channel spacing, in 10 kHz increments */
+    uint16_t bottom;
+    uint16_t top;
+    uint16_t spacing;
+
+    /* Bit mask of the band properties that have not been received yet */
+    uint8_t pendingProperties;
+
+    /* Frequency of the channel being measured */
+    uint16_t frequency;
+
+    /* Frequency to return to once the scan has finished */
+    uint16_t resumeFrequency;
+
+    /* Number of channels measured, and how many of them were valid */
+    uint16_t channelCount;
+    uint16_t validCount;
+
+    /* Time at which the scan started, in ms */
+    uint32_t startTick;
+
+    /* Results that have not been reported yet */
+    ScanResultsReport_t results;
+} Scan_t;
+
+/* Private constants ---------------------------------------------------------*/
+#define SCAN_PROPERTY_BOTTOM 0x01
+#define SCAN_PROPERTY_TOP 0x02
+#define SCAN_PROPERTY_SPACING 0x04
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+Scan_t scan = {.state = SCAN_STATE_IDLE};
+
+/* Private function prototypes -----------------------------------------------*/
+bool FlushScanResults(RadioDevice_t *device, bool isFinal);
+bool ReportScanSummary(RadioDevice_t *device);
+void ResumeScanOutput(RadioDevice_t *device);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Starts a scan of the seek band; the band limits and the channel
+ *         spacing are read from the radio first
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the scan was started; false otherwise
+ */
+bool StartScan(RadioDevice_t *device)
+{
+    if (scan.state != SCAN_STATE_IDLE || device->currentState == RADIOSTATE_POWERDOWN)
+    {
+        return false;
+    }
+
+    memset(&scan, 0, sizeof(scan));
+
+    scan.resumeFrequency = device->currentFrequency;
+    scan.pendingProperties = SCAN_PROPERTY_BOTTOM | SCAN_PROPERTY_TOP | SCAN_PROPERTY_SPACING;
+
+    // The band properties may be answered from the property shadow right away,
+    // so the scan must already be waiting for them
+    scan.state = SCAN_STATE_READING_BAND;
+    scan.startTick = HAL_GetTick();
+
+    if (!GetProperty(device, PROP_ID_FM_SEEK_BAND_BOTTOM) || !GetProperty(device, PROP_ID_FM_SEEK_BAND_TOP) ||
+        !GetProperty(device, PROP_ID_FM_SEEK_FREQ_SPACING))
+    {
+        scan.state = SCAN_STATE_IDLE;
+
+        return false;
+    }
+
+    // RSQ polling would only slow the scan down; the tune status has the same metrics
+    HAL_TIM_Base_Stop_IT(&htim16);
+
+    return true;
+}
+
+/**
+ * @brief  Asks the scan to stop after the channel that is currently being measured
+ */
+void StopScan(void)
+{
+    if (scan.state != SCAN_STATE_IDLE)
+    {
+        scan.isStopRequested = true;
+    }
+}
+
+/**
+ * @brief  Ends the scan right away without returning to the original station;
+ *         invoked when the host tunes, seeks or recalls a preset, which takes
+ *         the radio elsewhere, or when the command engine is restarted
+ */
+void AbortScan(void)
+{
+    if (scan.state == SCAN_STATE_IDLE)
+    {
+        return;
+    }
+
+    // The channel being measured, if any, is not recorded; the results so far are still reported
+    scan.resumeFrequency = 0;
+    scan.state = SCAN_STATE_FINISHING;
+}
+
+/**
+ * @brief  Checks whether a scan is in progress
+ *
+ * @retval True if a scan is in progress; false otherwise
+ */
+bool IsScanning(void)
+{
+    return scan.state != SCAN_STATE_IDLE;
+}
+
+/**
+ * @brief  Advances the scan to the next channel once the current one has been
+ *         measured, and reports the results; invoked from the main loop
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the scan progressed; false otherwise
+ */
+bool ProcessScan(RadioDevice_t *device)
+{
+    if (scan.state == SCAN_STATE_MEASURED)
+    {
+        // A full batch is reported before continuing, so no results are lost
+        // if the report queue happens to be full
+        if (scan.results.count >= SCAN_RECORDS_PER_REPORT && !FlushScanResults(device, false))
+        {
+            return false;
+        }
+
+        uint16_t next = scan.frequency + scan.spacing;
+
+        if (scan.isStopRequested || next > scan.top)
+        {
+            scan.state = SCAN_STATE_FINISHING;
+
+            return true;
+        }
+
+        if (!TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, next, 0))
+        {
+            return false;
+        }
+
+        scan.frequency = next;
+        scan.state = SCAN_STATE_MEASURING;
+
+        return true;
+    }
+    else if (scan.state == SCAN_STATE_FINISHING)
+    {
+        if (!FlushScanResults(device, true) || !ReportScanSummary(device))
+        {
+            return false;
+        }
+
+        scan.state = SCAN_STATE_IDLE;
+
+        // Return to the original station; this goes through the regular tune
+        // completion, which restarts the RSQ polling and the digital output
+        if (scan.resumeFrequency == 0 || !TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, scan.resumeFrequency, 0))
+        {
+            ResumeScanOutput(device);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief  Consumes a "Get Property" response that carries one of the band
+ *         properties requested by the scan; the first channel is tuned once
+ *         all of them have arrived
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the response was consumed by the scan; false otherwise
+ */
+bool ProcessScanProperty(RadioDevice_t *device, Command_t *command)
+{
+    if (scan.state != SCAN_STATE_READING_BAND)
+    {
+        return false;
+    }
+
+    PropertyIdentifiers_t property = (PropertyIdentifiers_t)((command->args.bytes[2] << 8) | command->args.bytes[3]);
+    uint16_t value = (uint16_t)((command->response[2] << 8) | command->response[3]);
+
+    switch (property)
+    {
+    case PROP_ID_FM_SEEK_BAND_BOTTOM:
+        scan.bottom = value;
+        scan.pendingProperties &= (uint8_t)~SCAN_PROPERTY_BOTTOM;
+        break;
+
+    case PROP_ID_FM_SEEK_BAND_TOP:
+        scan.top = value;
+        scan.pendingProperties &= (uint8_t)~SCAN_PROPERTY_TOP;
+        break;
+
+    case PROP_ID_FM_SEEK_FREQ_SPACING:
+        scan.spacing = value;
+        scan.pendingProperties &= (uint8_t)~SCAN_PROPERTY_SPACING;
+        break;
+
+    default:
+        return false;
+    }
+
+    if (scan.pendingProperties == 0)
+    {
+        if (scan.spacing == 0 || scan.bottom > scan.top || !TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, scan.bottom, 0))
+        {
+            // Nothing sensible to scan; report an empty result
+            scan.state = SCAN_STATE_FINISHING;
+
+            return true;
+        }
+
+        scan.frequency = scan.bottom;
+        scan.state = SCAN_STATE_MEASURING;
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Records the metrics of the channel being measured from the response
+ *         of the "Get Tune Status" command
+ * @param  device Pointer to the radio device structure
+ * @param  command Pointer to the command
+ *
+ * @retval True if the response was recorded by the scan; false otherwise
+ */
+bool ProcessScanTuneStatus(RadioDevice_t *device, Command_t *command)
+{
+    (void)device;
+
+    uint16_t frequency = (uint16_t)((command->response[2] << 8) | (command->response[3] << 0));
+
+    // A tune status of any other channel, such as one the host tuned to, is not a part of the scan
+    if (scan.state != SCAN_STATE_MEASURING || frequency != scan.frequency)
+    {
+        return false;
+    }
+
+    ScanRecord_t *record = &scan.results.records[scan.results.count++];
+
+    record->frequency = frequency;
+    record->isValid = command->response[1] & 0x01;
+    record->rssi = command->response[4];
+    record->snr = command->response[5];
+    record->multipath = command->response[6];
+
+    scan.channelCount++;
+
+    if (record->isValid)
+    {
+        scan.validCount++;
+    }
+
+    scan.state = SCAN_STATE_MEASURED;
+
+    return true;
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Enqueues the pending scan results as a new report
+ * @param  device Pointer to the radio device structure
+ * @param  isFinal True if these are the last results of the scan
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool FlushScanResults(RadioDevice_t *device, bool isFinal)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_SCAN_RESULTS;
+
+    scan.results.isFinal = isFinal;
+
+    memcpy(&report.bytes.scanResults, &scan.results, sizeof(ScanResultsReport_t));
+
+    if (!EnqueueReport(device, &report))
+    {
+        return false;
+    }
+
+    scan.results.sequence++;
+    scan.results.count = 0;
+
+    return true;
+}
+
+/**
+ * @brief  Enqueues the summary and the throughput of the scan as a new report
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportScanSummary(RadioDevice_t *device)
+{
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_SCAN_SUMMARY;
+
+    ScanSummaryReport_t *summary = &report.bytes.scanSummary;
+
+    uint32_t duration = HAL_GetTick() - scan.startTick;
+
+    summary->bottom = scan.bottom;
+    summary->top = scan.top;
+    summary->spacing = scan.spacing;
+    summary->channelCount = scan.channelCount;
+    summary->validCount = scan.validCount;
+    summary->isStopped = scan.isStopRequested;
+    summary->duration = duration;
+    summary->channelsPerSecond = duration > 0 ? (uint16_t)(((uint32_t)scan.channelCount * 100000UL) / duration) : 0;
+
+    return EnqueueReport(device, &report);
+}
+
+/**
+ * @brief  Restarts the RSQ polling and the digital output that the scan
+ *         stopped, when the scan does not tune back to a station
+ * @param  device Pointer to the radio device structure
+ */
+void ResumeScanOutput(RadioDevice_t *device)
+{
+    // A restarted radio resumes them itself once it has been powered up
+    if (device->currentState == RADIOSTATE_POWERDOWN)
+    {
+        return;
+    }
+
+    __HAL_TIM_SET_COUNTER(&htim16, 0);
+    __HAL_TIM_CLEAR_FLAG(&htim16, TIM_FLAG_UPDATE);
+
+    HAL_TIM_Base_Start_IT(&htim16);
+
+    SetProperty(device, PROP_ID_DIGITAL_OUTPUT_SAMPLE_RATE, CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE);
+}
@@ -0,0 +1,52 @@
+/**
+ ******************************************************************************
+ * @file    scan.h
+ * @brief   Header for scan.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __SCAN_H__
+#define __SCAN_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern bool StartScan(RadioDevice_t *device);
+extern void StopScan(void);
+extern void AbortScan(void);
+extern bool IsScanning(void);
+extern bool ProcessScan(RadioDevice_t *device);
+extern bool ProcessScanProperty(RadioDevice_t *device, Command_t *command);
+extern bool ProcessScanTuneStatus(RadioDevice_t *device, Command_t *command);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SCAN_H__ */
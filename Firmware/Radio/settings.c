@@ -0,0 +1,266 @@
+/**
+ ******************************************************************************
+ * @file    settings.c
+ * @brief   Persists the station, volume, mute and de-emphasis settings in
+ *          the flash storage, and restores them during boot
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "settings.h"
+#include "antcap.h"
+#include "boot.h"
+#include "commands.h"
+#include "main.h"
+#include "properties.h"
+#include "storage.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _Settings_t
+{
+    /* Frequency of the station, in 10 kHz increments */
+    uint16_t frequency;
+
+    /* Volume level */
+    uint8_t volume;
+
+    /* Mute status */
+    bool isMuted;
+
+    /* FM de-emphasis setting */
+    uint8_t deemphasis;
+} Settings_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+// Settings must stay unchanged this long before they are written, in ms; this
+// keeps e.g. a volume slider drag from turning into dozens of flash writes
+#define SETTINGS_SAVE_DELAY 5000
+
+// Range of frequencies accepted from the storage, in 10 kHz increments
+#define SETTINGS_MIN_FREQUENCY 6400
+#define SETTINGS_MAX_FREQUENCY 10800
+
+// clang-format off
+const Settings_t defaultSettings = {
+    .frequency = 9410,
+    .volume = SI4705_VOLUME_MAX_SETTING / 2,
+    .isMuted = false,
+    .deemphasis = FM_DEEMPHASIS_ARGS_50_MICROSECONDS
+};
+// clang-format on
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+// Settings as they currently are in the storage
+Settings_t savedSettings;
+
+// Settings as they were during the previous call, and the time they last changed
+Settings_t observedSettings;
+uint32_t settingsChangeTick = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+Settings_t CaptureSettings(RadioDevice_t *device);
+bool AreSettingsEqual(const Settings_t *a, const Settings_t *b);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Reads the settings from the storage, and enqueues the commands that
+ *         apply them; missing or invalid settings fall back to the defaults
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the commands were enqueued; false otherwise
+ */
+bool RestoreSettings(RadioDevice_t *device)
+{
+    Settings_t settings = defaultSettings;
+
+    if (StorageInit())
+    {
+        uint16_t value;
+
+        // Before the first tune, so the presets already tune with their stored values
+        SeedAntennaCapacitors();
+
+        if (StorageRead(STORAGE_KEY_FREQUENCY, &value) && value >= SETTINGS_MIN_FREQUENCY &&
+            value <= SETTINGS_MAX_FREQUENCY)
+        {
+            settings.frequency = value;
+        }
+
+        if (StorageRead(STORAGE_KEY_VOLUME, &value) && value <= SI4705_VOLUME_MAX_SETTING)
+        {
+            settings.volume = (uint8_t)value;
+        }
+
+        if (StorageRead(STORAGE_KEY_MUTE, &value))
+        {
+            settings.isMuted = value != 0;
+        }
+
+        if (StorageRead(STORAGE_KEY_DEEMPHASIS, &value) &&
+            (value == FM_DEEMPHASIS_ARGS_50_MICROSECONDS || value == FM_DEEMPHASIS_ARGS_75_MICROSECONDS))
+        {
+            settings.deemphasis = (uint8_t)value;
+        }
+    }
+
+    savedSettings = settings;
+    observedSettings = settings;
+
+    if (!SetVolume(device, settings.volume))
+    {
+        return false;
+    }
+
+    if (!SetMute(device, settings.isMuted ? RX_HARD_MUTE_ARGS_BOTH : RX_HARD_MUTE_ARGS_NONE))
+    {
+        return false;
+    }
+
+    if (!SetFMDeemphasis(device, (PROP_FM_DEEMPHASIS_ARGS)settings.deemphasis))
+    {
+        return false;
+    }
+
+    return TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, settings.frequency, 0);
+}
+
+/**
+ * @brief  Writes the settings into the storage once they have stayed unchanged
+ *         long enough; invoked from the main loop
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the settings were written; false otherwise
+ */
+bool ProcessSettings(RadioDevice_t *device)
+{
+    // Until the restored settings have been applied, the device state still
+    // holds the power-on defaults
+    if (!HasBootMilestone(BOOT_MILESTONE_RADIO_READY))
+    {
+        return false;
+    }
+
+    Settings_t current = CaptureSettings(device);
+
+    if (!AreSettingsEqual(&current, &observedSettings))
+    {
+        observedSettings = current;
+        settingsChangeTick = HAL_GetTick();
+
+        return false;
+    }
+
+    if (AreSettingsEqual(&current, &savedSettings) || HAL_GetTick() - settingsChangeTick < SETTINGS_SAVE_DELAY)
+    {
+        return false;
+    }
+
+    // Programming the flash stalls the CPU; do not hold up a command in flight
+    if (device->commandQueue.count > 0)
+    {
+        return false;
+    }
+
+    bool isWritten = StorageWrite(STORAGE_KEY_FREQUENCY, current.frequency) &&
+                     StorageWrite(STORAGE_KEY_VOLUME, current.volume) &&
+                     StorageWrite(STORAGE_KEY_MUTE, current.isMuted) &&
+                     StorageWrite(STORAGE_KEY_DEEMPHASIS, current.deemphasis);
+
+    // Even if the storage failed, do not retry on every round
+    savedSettings = current;
+
+    return isWritten;
+}
+
+/**
+ * @brief  Enqueues the commands that bring a restarted radio back to the
+ *         state it had before; unlike the restore at startup, the settings
+ *         come from the device state rather than the storage
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the commands were enqueued; false otherwise
+ */
+bool ReapplySettings(RadioDevice_t *device)
+{
+    // Falls back to the last observed frequency when the radio was not tuned at the time
+    Settings_t settings = CaptureSettings(device);
+
+    if (!SetVolume(device, settings.volume))
+    {
+        return false;
+    }
+
+    if (!SetMute(device, settings.isMuted ? RX_HARD_MUTE_ARGS_BOTH : RX_HARD_MUTE_ARGS_NONE))
+    {
+        return false;
+    }
+
+    if (!SetFMDeemphasis(device, (PROP_FM_DEEMPHASIS_ARGS)settings.deemphasis))
+    {
+        return false;
+    }
+
+    // The radio powers up with the RF AGC enabled
+    if (device->isAGCDisabled && !AGCOverride(device, FM_AGC_OVERRIDE_ARGS_RFAGCDIS, device->lnaGainIndex))
+    {
+        return false;
+    }
+
+    return TuneFreq(device, FM_TUNE_FREQ_ARGS_NONE, settings.frequency, 0);
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Collects the persisted settings from the radio device state
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval Current settings
+ */
+Settings_t CaptureSettings(RadioDevice_t *device)
+{
+    Settings_t settings = observedSettings;
+
+    // The frequency is only meaningful while tuned to a valid channel
+    if ((device->currentState == RADIOSTATE_TUNED_TO_STATION ||
+         device->currentState == RADIOSTATE_DIGITAL_OUTPUT_ENABLED) &&
+        device->currentFrequency != 0)
+    {
+        settings.frequency = device->currentFrequency;
+    }
+
+    settings.volume = device->currentVolume;
+    settings.isMuted = device->isMuted;
+    settings.deemphasis = device->currentDeemphasis;
+
+    return settings;
+}
+
+/**
+ * @brief  Compares two sets of settings
+ *
+ * @retval True if the settings are equal; false otherwise
+ */
+bool AreSettingsEqual(const Settings_t *a, const Settings_t *b)
+{
+    return a->frequency == b->frequency && a->volume == b->volume && a->isMuted == b->isMuted &&
+           a->deemphasis == b->deemphasis;
+}
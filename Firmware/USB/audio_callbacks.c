@@ -14,6 +14,7 @@
  ******************************************************************************
  */
 #include "audio_config.h"
+#include "audio_monitor.h"
 #include "commands.h"
 #include "device.h"
 #include "i2s.h"
@@ -35,6 +36,9 @@ bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const *p_reques
     // uint8_t const itf = tu_u16_low(tu_le16toh(p_request->wIndex));
     uint8_t const alt = tu_u16_low(tu_le16toh(p_request->wValue));
 
+    // Let the audio monitor know whether losses should be accounted for
+    SetAudioStreaming(alt == ALTERNATIVE_SETTING_ENABLE);
+
     // Clear buffer when streaming format is changed
     if (alt == 1)
     {
@@ -0,0 +1,502 @@
+/**
+ ******************************************************************************
+ * @file    audio_monitor.c
+ * @brief   Feeds the I2S samples into the USB audio FIFO, and keeps track of
+ *          the health of the audio pipeline
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_monitor.h"
+#include "audio_config.h"
+#include "boot.h"
+#include "device.h"
+#include "tim.h"
+#include "tusb.h"
+
+/* Global variables ----------------------------------------------------------*/
+
+/* Private types -------------------------------------------------------------*/
+typedef struct _AudioStatistics_t
+{
+    /* Set when the host has enabled the streaming interface */
+    bool isStreaming;
+
+    /* Set by timer 17 when the current window is due for reporting */
+    bool isReportDue;
+
+    /* Total number of samples that did not fit into the USB FIFO while streaming */
+    uint32_t droppedSamples;
+
+    /* Total number of FIFO writes that were shorter than requested while streaming */
+    uint32_t shortWrites;
+
+    /* Total number of times the FIFO was found empty while streaming */
+    uint32_t underruns;
+
+    /* Timestamp of the previous DMA callback, in µs */
+    uint32_t previousCallback;
+
+    /* Length of the most recent write, in bytes */
+    uint16_t writeLength;
+
+    /* Number of DMA callbacks during the current window */
+    uint16_t callbackCount;
+
+    /* Shortest and longest period between DMA callbacks during the current window, in µs */
+    uint16_t minimumCallbackPeriod;
+    uint16_t maximumCallbackPeriod;
+
+    /* FIFO fill level histogram for the current window */
+    uint16_t fifoFillHistogram[AUDIO_FIFO_HISTOGRAM_BUCKETS];
+} AudioStatistics_t;
+
+typedef struct _AudioLevels_t
+{
+    /* Length of the metering window, in frames; a power of two, so the mean square is a shift */
+    uint32_t windowFrames;
+
+    /* Number of frames accumulated into the current window */
+    uint32_t frames;
+
+    /* Largest absolute sample value of each channel during the current window */
+    uint16_t peak[AUDIO_LEVEL_CHANNELS];
+
+    /* Sum of the squared sample values of each channel during the current window */
+    uint64_t sumOfSquares[AUDIO_LEVEL_CHANNELS];
+
+    /* Set by the host to discard the current window, e.g. after the window length changes */
+    bool isRestartRequested;
+
+    /* Set when a completed window has been latched and awaits reporting */
+    bool isReady;
+
+    /* Completed window, a power of two frames long; owned by the main loop while isReady is set */
+    uint32_t readyFrames;
+    uint16_t readyPeak[AUDIO_LEVEL_CHANNELS];
+    uint64_t readySumOfSquares[AUDIO_LEVEL_CHANNELS];
+} AudioLevels_t;
+
+/* Private constants ---------------------------------------------------------*/
+
+// Number of bytes the I2S produces each second
+#define AUDIO_BYTES_PER_SECOND                                                                                         \
+    (CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX *                                           \
+     (CFG_TUD_AUDIO_FUNC_1_FORMAT_1_N_BYTES_PER_SAMPLE_TX))
+
+// Number of frames the I2S produces each millisecond
+#define AUDIO_FRAMES_PER_MILLISECOND (CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE / 1000)
+
+// Default length of the metering window, in frames; about 85 ms
+#define AUDIO_LEVEL_DEFAULT_WINDOW_FRAMES 4096
+
+// Limits for the metering window requested by the host, in ms
+#define AUDIO_LEVEL_MINIMUM_WINDOW 10
+#define AUDIO_LEVEL_MAXIMUM_WINDOW 10000
+
+/* Private macros ------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+volatile AudioStatistics_t audioStatistics = {.minimumCallbackPeriod = UINT16_MAX};
+volatile AudioLevels_t audioLevels = {.windowFrames = AUDIO_LEVEL_DEFAULT_WINDOW_FRAMES};
+
+/* Private function prototypes -----------------------------------------------*/
+void IncrementSaturating(volatile uint16_t *counter);
+void MeasureAudioLevels(const uint16_t *samples, uint16_t length);
+uint16_t SquareRoot(uint32_t value);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  Writes a block of I2S samples into the USB audio FIFO, and updates the
+ *         audio pipeline statistics; invoked from the DMA half/full callbacks
+ * @param  samples Pointer to the first sample of the block
+ * @param  length Length of the block, in bytes
+ *
+ * @retval Number of bytes that were written into the FIFO
+ */
+uint16_t WriteAudioSamples(const uint16_t *samples, uint16_t length)
+{
+    uint32_t now = GetMicroseconds();
+
+    if (audioStatistics.previousCallback != 0)
+    {
+        uint32_t period = now - audioStatistics.previousCallback;
+
+        if (period > UINT16_MAX)
+        {
+            period = UINT16_MAX;
+        }
+
+        if (period < audioStatistics.minimumCallbackPeriod)
+        {
+            audioStatistics.minimumCallbackPeriod = (uint16_t)period;
+        }
+
+        if (period > audioStatistics.maximumCallbackPeriod)
+        {
+            audioStatistics.maximumCallbackPeriod = (uint16_t)period;
+        }
+    }
+
+    audioStatistics.previousCallback = now;
+    audioStatistics.writeLength = length;
+
+    IncrementSaturating(&audioStatistics.callbackCount);
+
+    // Sample the FIFO fill level before the write so the histogram shows how much
+    // the host has left behind since the previous callback
+    tu_fifo_t *fifo = tud_audio_get_ep_in_ff();
+    uint16_t fifoCount = tu_fifo_count(fifo);
+    uint16_t fifoDepth = tu_fifo_depth(fifo);
+
+    uint16_t bucket = (uint16_t)(((uint32_t)fifoCount * AUDIO_FIFO_HISTOGRAM_BUCKETS) / fifoDepth);
+
+    if (bucket >= AUDIO_FIFO_HISTOGRAM_BUCKETS)
+    {
+        bucket = AUDIO_FIFO_HISTOGRAM_BUCKETS - 1;
+    }
+
+    IncrementSaturating(&audioStatistics.fifoFillHistogram[bucket]);
+
+    uint16_t written = tud_audio_write(samples, length);
+
+    // Metering runs whether or not the host is streaming, so that silence can
+    // be detected without opening the isochronous endpoint
+    MeasureAudioLevels(samples, length);
+
+    // When the host is not streaming the FIFO is expected to stay full, so
+    // only account for losses while the stream is open
+    if (audioStatistics.isStreaming)
+    {
+        if (fifoCount == 0)
+        {
+            audioStatistics.underruns++;
+        }
+
+        if (written < length)
+        {
+            audioStatistics.shortWrites++;
+            audioStatistics.droppedSamples += (length - written) / sizeof(uint16_t);
+        }
+        else if (radioDevice.currentState == RADIOSTATE_DIGITAL_OUTPUT_ENABLED)
+        {
+            RecordBootMilestone(BOOT_MILESTONE_FIRST_AUDIO);
+        }
+    }
+
+    return written;
+}
+
+/**
+ * @brief  Informs the monitor whether the host has opened the audio stream
+ * @param  isStreaming True if the streaming interface is enabled; false otherwise
+ */
+void SetAudioStreaming(bool isStreaming)
+{
+    audioStatistics.isStreaming = isStreaming;
+}
+
+/**
+ * @brief  Marks the current window of the audio pipeline statistics due for
+ *         reporting; invoked from the timer 17 interrupt once a second
+ */
+void MarkAudioStatisticsDue(void)
+{
+    audioStatistics.isReportDue = true;
+}
+
+/**
+ * @brief  Enqueues the audio pipeline statistics as a new report once the
+ *         window is due and the IN endpoint is free, and begins a new window
+ *         for the callback periods and the FIFO fill histogram once the
+ *         report has been enqueued
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if the report was enqueued; false otherwise
+ */
+bool ReportAudioStatistics(RadioDevice_t *device)
+{
+    if (!audioStatistics.isReportDue || !tud_hid_ready())
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_AUDIO_STATISTICS;
+
+    AudioStatisticsReport_t *statistics = &report.bytes.audioStatistics;
+
+    // The DMA callbacks keep updating the window while it is copied
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    statistics->isStreaming = audioStatistics.isStreaming;
+    statistics->droppedSamples = audioStatistics.droppedSamples;
+    statistics->shortWrites = audioStatistics.shortWrites;
+    statistics->underruns = audioStatistics.underruns;
+    statistics->callbackCount = audioStatistics.callbackCount;
+    statistics->expectedCallbackPeriod =
+        (uint16_t)(((uint32_t)audioStatistics.writeLength * 1000000UL) / AUDIO_BYTES_PER_SECOND);
+    statistics->minimumCallbackPeriod =
+        audioStatistics.callbackCount > 1 ? audioStatistics.minimumCallbackPeriod : 0;
+    statistics->maximumCallbackPeriod = audioStatistics.maximumCallbackPeriod;
+
+    for (uint8_t i = 0; i < AUDIO_FIFO_HISTOGRAM_BUCKETS; i++)
+    {
+        statistics->fifoFillHistogram[i] = audioStatistics.fifoFillHistogram[i];
+    }
+
+    __set_PRIMASK(primask);
+
+    if (!EnqueueReport(device, &report))
+    {
+        return false;
+    }
+
+    // The callbacks that arrived after the copy carry over into the new window
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < AUDIO_FIFO_HISTOGRAM_BUCKETS; i++)
+    {
+        audioStatistics.fifoFillHistogram[i] -= statistics->fifoFillHistogram[i];
+    }
+
+    audioStatistics.callbackCount -= statistics->callbackCount;
+    audioStatistics.minimumCallbackPeriod = UINT16_MAX;
+    audioStatistics.maximumCallbackPeriod = 0;
+    audioStatistics.isReportDue = false;
+
+    __set_PRIMASK(primask);
+
+    return true;
+}
+
+/**
+ * @brief  Changes the length of the audio level metering window; the current
+ *         window is discarded
+ * @param  window Length of the window, in ms; rounded to the nearest power of two frames
+ */
+void SetAudioLevelWindow(uint16_t window)
+{
+    if (window < AUDIO_LEVEL_MINIMUM_WINDOW)
+    {
+        window = AUDIO_LEVEL_MINIMUM_WINDOW;
+    }
+    else if (window > AUDIO_LEVEL_MAXIMUM_WINDOW)
+    {
+        window = AUDIO_LEVEL_MAXIMUM_WINDOW;
+    }
+
+    uint32_t frames = (uint32_t)window * AUDIO_FRAMES_PER_MILLISECOND;
+    uint32_t windowFrames = 1;
+
+    while (windowFrames < frames)
+    {
+        windowFrames <<= 1;
+    }
+
+    if (windowFrames - frames > frames - (windowFrames >> 1))
+    {
+        windowFrames >>= 1;
+    }
+
+    audioLevels.windowFrames = windowFrames;
+    audioLevels.isRestartRequested = true;
+}
+
+/**
+ * @brief  Enqueues the peak and RMS levels of the most recently completed
+ *         metering window as a new report; does nothing if no window has
+ *         completed since the previous call
+ * @param  device Pointer to the radio device structure
+ *
+ * @retval True if a report was enqueued; false otherwise
+ */
+bool ReportAudioLevels(RadioDevice_t *device)
+{
+    if (!audioLevels.isReady)
+    {
+        return false;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = REPORT_IDENTIFIER_AUDIO_LEVELS;
+
+    AudioLevelReport_t *levels = &report.bytes.audioLevels;
+
+    uint32_t frames = audioLevels.readyFrames;
+
+    // The window is a power of two frames long, so the mean square is a shift
+    // instead of a 64-bit division, which the Cortex-M0 would do in a library call
+    uint8_t shift = 0;
+
+    while ((1UL << shift) < frames)
+    {
+        shift++;
+    }
+
+    levels->window = (uint16_t)(frames / AUDIO_FRAMES_PER_MILLISECOND);
+    levels->peakLeft = audioLevels.readyPeak[0];
+    levels->peakRight = audioLevels.readyPeak[1];
+    levels->rmsLeft = SquareRoot((uint32_t)(audioLevels.readySumOfSquares[0] >> shift));
+    levels->rmsRight = SquareRoot((uint32_t)(audioLevels.readySumOfSquares[1] >> shift));
+
+    // Hand the latch back to the DMA callback
+    audioLevels.isReady = false;
+
+    return EnqueueReport(device, &report);
+}
+
+/* External callbacks --------------------------------------------------------*/
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief  Increments a 16-bit counter without letting it wrap around
+ * @param  counter Pointer to the counter
+ */
+void IncrementSaturating(volatile uint16_t *counter)
+{
+    if (*counter < UINT16_MAX)
+    {
+        (*counter)++;
+    }
+}
+
+/**
+ * @brief  Accumulates the per-channel peak and sum of squares of a block of
+ *         interleaved stereo samples, and latches the window once it completes
+ * @param  samples Pointer to the first sample of the block
+ * @param  length Length of the block, in bytes
+ *
+ * @remark The kernel only uses 32-bit multiplies and 64-bit additions, which
+ *         the Cortex-M0 handles without library calls
+ */
+void MeasureAudioLevels(const uint16_t *samples, uint16_t length)
+{
+    if (audioLevels.isRestartRequested)
+    {
+        audioLevels.isRestartRequested = false;
+        audioLevels.frames = 0;
+        audioLevels.peak[0] = audioLevels.peak[1] = 0;
+        audioLevels.sumOfSquares[0] = audioLevels.sumOfSquares[1] = 0;
+    }
+
+    const int16_t *sample = (const int16_t *)samples;
+    uint16_t remaining = length / (AUDIO_LEVEL_CHANNELS * sizeof(int16_t));
+
+    while (remaining > 0)
+    {
+        // The window ends at the next power of two frames; if the previous window
+        // has not been reported yet, this one keeps accumulating to twice its length
+        // instead of overwriting it
+        uint32_t boundary = audioLevels.windowFrames;
+
+        while (boundary <= audioLevels.frames)
+        {
+            boundary <<= 1;
+        }
+
+        uint32_t untilBoundary = boundary - audioLevels.frames;
+        uint16_t frames = (uint16_t)(untilBoundary < remaining ? untilBoundary : remaining);
+
+        // Work on locals so the loop is not slowed down by volatile accesses
+        uint32_t peakLeft = audioLevels.peak[0];
+        uint32_t peakRight = audioLevels.peak[1];
+        uint64_t sumLeft = 0;
+        uint64_t sumRight = 0;
+
+        for (uint16_t i = 0; i < frames; i++)
+        {
+            int32_t left = *sample++;
+            int32_t right = *sample++;
+
+            uint32_t magnitudeLeft = (uint32_t)(left < 0 ? -left : left);
+            uint32_t magnitudeRight = (uint32_t)(right < 0 ? -right : right);
+
+            if (magnitudeLeft > peakLeft)
+            {
+                peakLeft = magnitudeLeft;
+            }
+
+            if (magnitudeRight > peakRight)
+            {
+                peakRight = magnitudeRight;
+            }
+
+            sumLeft += (uint32_t)(left * left);
+            sumRight += (uint32_t)(right * right);
+        }
+
+        // A full-scale negative sample has no positive counterpart; clamp it
+        audioLevels.peak[0] = (uint16_t)(peakLeft > INT16_MAX ? INT16_MAX : peakLeft);
+        audioLevels.peak[1] = (uint16_t)(peakRight > INT16_MAX ? INT16_MAX : peakRight);
+        audioLevels.sumOfSquares[0] += sumLeft;
+        audioLevels.sumOfSquares[1] += sumRight;
+        audioLevels.frames += frames;
+
+        remaining -= frames;
+
+        if (audioLevels.frames == boundary && !audioLevels.isReady)
+        {
+            audioLevels.readyFrames = audioLevels.frames;
+            audioLevels.readyPeak[0] = audioLevels.peak[0];
+            audioLevels.readyPeak[1] = audioLevels.peak[1];
+            audioLevels.readySumOfSquares[0] = audioLevels.sumOfSquares[0];
+            audioLevels.readySumOfSquares[1] = audioLevels.sumOfSquares[1];
+            audioLevels.isReady = true;
+
+            audioLevels.frames = 0;
+            audioLevels.peak[0] = audioLevels.peak[1] = 0;
+            audioLevels.sumOfSquares[0] = audioLevels.sumOfSquares[1] = 0;
+        }
+    }
+}
+
+/**
+ * @brief  Calculates the integer square root of a value bit by bit, without
+ *         relying on division
+ * @param  value Value whose square root is calculated
+ *
+ * @retval Square root of the value, rounded down
+ */
+uint16_t SquareRoot(uint32_t value)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return (uint16_t)result;
+}
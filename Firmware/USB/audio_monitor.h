@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file    audio_monitor.h
+ * @brief   Header for audio_monitor.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 Antti Keskinen
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ *
+ ******************************************************************************
+ */
+
+/* Header guard --------------------------------------------------------------*/
+#ifndef __AUDIO_MONITOR_H__
+#define __AUDIO_MONITOR_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types */
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macros -----------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+extern uint16_t WriteAudioSamples(const uint16_t *samples, uint16_t length);
+extern void SetAudioStreaming(bool isStreaming);
+extern void MarkAudioStatisticsDue(void);
+extern bool ReportAudioStatistics(RadioDevice_t *device);
+extern void SetAudioLevelWindow(uint16_t window);
+extern bool ReportAudioLevels(RadioDevice_t *device);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __AUDIO_MONITOR_H__ */
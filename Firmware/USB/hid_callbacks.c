@@ -13,13 +13,28 @@
  *
  ******************************************************************************
  */
+#include "af.h"
+#include "antcap.h"
+#include "audio_monitor.h"
 #include "commands.h"
 #include "device.h"
 #include "hid_config.h"
+#include "macros.h"
+#include "memory.h"
+#include "passthrough.h"
+#include "presets.h"
+#include "properties.h"
+#include "rds.h"
+#include "scan.h"
+#include "telemetry.h"
 #include "tusb.h"
+#include <string.h>
 
 extern uint8_t desc_hid_report[];
 
+// Report the feature report returns a snapshot of
+ReportIdentifier_t snapshotIdentifier = REPORT_IDENTIFIER_RADIO_STATUS;
+
 /**
  * @brief  Invoked when the GET HID REPORT DESCRIPTOR request is received
  * @param  itf Interface number
@@ -38,17 +53,66 @@ uint8_t const *tud_hid_descriptor_report_cb(uint8_t itf)
  * @param  itf Interface number
  *
  * @retval Amount of bytes to report back to the host; retuning zero will STALL the endpoint
+ *
+ * @remark The feature report returns a snapshot of the current state for the
+ *         report selected with REPORT_IDENTIFIER_SNAPSHOT_SELECT, laid out like
+ *         an input report: the identifier, then the struct bytes
  */
 uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer,
                                uint16_t reqlen)
 {
     (void)instance;
-    (void)report_id;
-    (void)report_type;
-    (void)buffer;
-    (void)reqlen;
 
-    return 0;
+    if (report_type != HID_REPORT_TYPE_FEATURE)
+    {
+        return 0;
+    }
+
+    // The report descriptor declares no report identifiers, so the feature report is report zero
+    if (report_id != 0)
+    {
+        return 0;
+    }
+
+    Report_t report = {0};
+
+    report.identifier = snapshotIdentifier;
+
+    switch (report.identifier)
+    {
+    case REPORT_IDENTIFIER_RADIO_STATUS:
+        BuildRadioStatusReport(&radioDevice, &report);
+        break;
+    case REPORT_IDENTIFIER_RSQ_STATUS:
+        if (!GetLastRSQStatus(&report.bytes.rsqStatus))
+        {
+            return 0;
+        }
+        break;
+    case REPORT_IDENTIFIER_RDS_PROGRAMME_SERVICE:
+        RDSGetProgrammeService(report.bytes.programmeService.programmeService);
+        break;
+    case REPORT_IDENTIFIER_RDS_RADIO_TEXT:
+        RDSGetRadioText(report.bytes.radioText.radioText);
+        break;
+    case REPORT_IDENTIFIER_TELEMETRY:
+        FillTelemetryReport(&report.bytes.telemetry);
+        break;
+    default:
+        return 0;
+    }
+
+    StampSnapshot(&report);
+
+    if (reqlen < MAX_REPORT_SIZE)
+    {
+        return 0;
+    }
+
+    buffer[0] = report.identifier;
+    memcpy(&buffer[1], report.bytes.raw, MAX_STRUCT_SIZE);
+
+    return MAX_REPORT_SIZE;
 }
 
 /**
@@ -74,7 +138,14 @@ void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_
         TuneFreqRequest_t tuneFreqRequest = {0};
         memcpy(&tuneFreqRequest, &buffer[1], sizeof(TuneFreqRequest_t));
 
-        TuneFreq(&radioDevice, FM_TUNE_FREQ_ARGS_NONE, tuneFreqRequest.frequency);
+        AbortAlternativeFrequencyCheck(&radioDevice);
+        AbortScan();
+        AbortAntennaCapacitorBenchmark(&radioDevice);
+
+        // Latest wins; a tune that has not been started yet is replaced by this one
+        RemoveCommands(&radioDevice, CMD_ID_FM_TUNE_FREQ);
+
+        TuneFreq(&radioDevice, FM_TUNE_FREQ_ARGS_NONE, tuneFreqRequest.frequency, 0);
 
         break;
 
@@ -94,10 +165,149 @@ void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_
             seekStartArgs |= FM_SEEK_START_ARGS_UP;
         }
 
+        AbortAlternativeFrequencyCheck(&radioDevice);
+        AbortScan();
+        AbortAntennaCapacitorBenchmark(&radioDevice);
+
         SeekStart(&radioDevice, seekStartArgs);
 
         break;
 
+    case REPORT_IDENTIFIER_SEEK_CANCEL:
+        CancelSeek(&radioDevice);
+
+        break;
+
+    case REPORT_IDENTIFIER_ANTCAP_BENCHMARK_START:
+        StartAntennaCapacitorBenchmark(&radioDevice);
+
+        break;
+
+    case REPORT_IDENTIFIER_AGC_OVERRIDE:
+        AGCOverrideRequest_t agcOverrideRequest = {0};
+        memcpy(&agcOverrideRequest, &buffer[1], sizeof(AGCOverrideRequest_t));
+
+        AGCOverride(&radioDevice,
+                    agcOverrideRequest.isAGCDisabled ? FM_AGC_OVERRIDE_ARGS_RFAGCDIS : FM_AGC_OVERRIDE_ARGS_NONE,
+                    agcOverrideRequest.lnaGainIndex);
+
+        break;
+
+    case REPORT_IDENTIFIER_PROPERTY_SET_BULK:
+    case REPORT_IDENTIFIER_PROPERTY_GET_BULK:
+        PropertyBulkRequest_t propertyBulkRequest = {0};
+        memcpy(&propertyBulkRequest, &buffer[1], sizeof(PropertyBulkRequest_t));
+
+        StartPropertyBulk(&radioDevice, &propertyBulkRequest, reportId == REPORT_IDENTIFIER_PROPERTY_SET_BULK);
+
+        break;
+
+    case REPORT_IDENTIFIER_AF_CONFIG:
+        AlternativeFrequencyConfigRequest_t alternativeFrequencyConfigRequest = {0};
+        memcpy(&alternativeFrequencyConfigRequest, &buffer[1], sizeof(AlternativeFrequencyConfigRequest_t));
+
+        ConfigureAlternativeFrequencies(&alternativeFrequencyConfigRequest);
+
+        break;
+
+    case REPORT_IDENTIFIER_TELEMETRY_REQUEST:
+        TelemetryRequest_t telemetryRequest = {0};
+        memcpy(&telemetryRequest, &buffer[1], sizeof(TelemetryRequest_t));
+
+        ConfigureTelemetry(&telemetryRequest);
+        RequestMemoryUsageReport();
+
+        break;
+
+    case REPORT_IDENTIFIER_RADIO_STATUS_HEARTBEAT:
+        RadioStatusHeartbeatRequest_t radioStatusHeartbeatRequest = {0};
+        memcpy(&radioStatusHeartbeatRequest, &buffer[1], sizeof(RadioStatusHeartbeatRequest_t));
+
+        ConfigureRadioStatusHeartbeat(&radioStatusHeartbeatRequest);
+
+        break;
+
+    case REPORT_IDENTIFIER_PASSTHROUGH:
+        PassthroughRequest_t passthroughRequest = {0};
+        memcpy(&passthroughRequest, &buffer[1], sizeof(PassthroughRequest_t));
+
+        EnqueuePassthroughCommand(&radioDevice, &passthroughRequest);
+
+        break;
+
+    case REPORT_IDENTIFIER_MACRO_STORE:
+        MacroStoreRequest_t macroStoreRequest = {0};
+        memcpy(&macroStoreRequest, &buffer[1], sizeof(MacroStoreRequest_t));
+
+        StoreMacro(&macroStoreRequest);
+
+        break;
+
+    case REPORT_IDENTIFIER_MACRO_RUN:
+        MacroRunRequest_t macroRunRequest = {0};
+        memcpy(&macroRunRequest, &buffer[1], sizeof(MacroRunRequest_t));
+
+        RunMacro(&radioDevice, macroRunRequest.macroId);
+
+        break;
+
+    case REPORT_IDENTIFIER_SNAPSHOT_SELECT:
+        SnapshotSelectRequest_t snapshotSelectRequest = {0};
+        memcpy(&snapshotSelectRequest, &buffer[1], sizeof(SnapshotSelectRequest_t));
+
+        snapshotIdentifier = (ReportIdentifier_t)snapshotSelectRequest.identifier;
+
+        break;
+
+    case REPORT_IDENTIFIER_SET_AUDIO_LEVEL_WINDOW:
+        AudioLevelWindowRequest_t audioLevelWindowRequest = {0};
+        memcpy(&audioLevelWindowRequest, &buffer[1], sizeof(AudioLevelWindowRequest_t));
+
+        SetAudioLevelWindow(audioLevelWindowRequest.window);
+
+        break;
+
+    case REPORT_IDENTIFIER_PRESET_STORE:
+        PresetStoreRequest_t presetStoreRequest = {0};
+        memcpy(&presetStoreRequest, &buffer[1], sizeof(PresetStoreRequest_t));
+
+        // A store that is refused is answered with the unchanged preset list
+        if (!StorePreset(&radioDevice, presetStoreRequest.index, presetStoreRequest.frequency))
+        {
+            ReportPresets(&radioDevice);
+        }
+
+        break;
+
+    case REPORT_IDENTIFIER_PRESET_LIST_REQUEST:
+        ReportPresets(&radioDevice);
+
+        break;
+
+    case REPORT_IDENTIFIER_PRESET_RECALL:
+        PresetRecallRequest_t presetRecallRequest = {0};
+        memcpy(&presetRecallRequest, &buffer[1], sizeof(PresetRecallRequest_t));
+
+        AbortAlternativeFrequencyCheck(&radioDevice);
+        AbortScan();
+        AbortAntennaCapacitorBenchmark(&radioDevice);
+
+        RecallPreset(&radioDevice, presetRecallRequest.index);
+
+        break;
+
+    case REPORT_IDENTIFIER_SCAN_START:
+        AbortAntennaCapacitorBenchmark(&radioDevice);
+
+        StartScan(&radioDevice);
+
+        break;
+
+    case REPORT_IDENTIFIER_SCAN_STOP:
+        StopScan();
+
+        break;
+
     default:
         // Unrecognized report ID; ignore
         break;
@@ -85,10 +85,38 @@ static inline size_t board_usb_get_serial(uint16_t desc_str1[], size_t maxChars)
 // HID Report Descriptor
 //--------------------------------------------------------------------+
 
+// The generic in/out layout, plus a feature report of the same size; none of them
+// has a report identifier. Reading the feature report returns a snapshot of the
+// report selected with a SNAPSHOT_SELECT request, which may also be sent as a
+// feature report so that it is ordered with the read on the control pipe
 // clang-format off
 uint8_t const desc_hid_report[] = 
 {
-	TUD_HID_REPORT_DESC_GENERIC_INOUT(CFG_TUD_HID_EP_BUFSIZE)
+	HID_USAGE_PAGE_N  ( HID_USAGE_PAGE_VENDOR, 2                ),
+	HID_USAGE         ( 0x01                                    ),
+	HID_COLLECTION    ( HID_COLLECTION_APPLICATION              ),
+	  // Input
+	  HID_USAGE         ( 0x02                                    ),
+	  HID_LOGICAL_MIN   ( 0x00                                    ),
+	  HID_LOGICAL_MAX_N ( 0xff, 2                                 ),
+	  HID_REPORT_SIZE   ( 8                                       ),
+	  HID_REPORT_COUNT  ( CFG_TUD_HID_EP_BUFSIZE                  ),
+	  HID_INPUT         ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE  ),
+	  // Output
+	  HID_USAGE         ( 0x03                                    ),
+	  HID_LOGICAL_MIN   ( 0x00                                    ),
+	  HID_LOGICAL_MAX_N ( 0xff, 2                                 ),
+	  HID_REPORT_SIZE   ( 8                                       ),
+	  HID_REPORT_COUNT  ( CFG_TUD_HID_EP_BUFSIZE                  ),
+	  HID_OUTPUT        ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE  ),
+	  // Feature
+	  HID_USAGE         ( 0x04                                    ),
+	  HID_LOGICAL_MIN   ( 0x00                                    ),
+	  HID_LOGICAL_MAX_N ( 0xff, 2                                 ),
+	  HID_REPORT_SIZE   ( 8                                       ),
+	  HID_REPORT_COUNT  ( CFG_TUD_HID_EP_BUFSIZE                  ),
+	  HID_FEATURE       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE  ),
+	HID_COLLECTION_END
 };
 // clang-format on
 
@@ -0,0 +1,144 @@
+# Prints the flash and RAM used by each module, read from the map file written by the linker
+#
+# Usage: cmake -DMAP_FILE=<path to the map file> -P memory-report.cmake
+
+if(NOT DEFINED MAP_FILE OR NOT EXISTS "${MAP_FILE}")
+    message(FATAL_ERROR "Map file \"${MAP_FILE}\" not found; build the firmware first")
+endif()
+
+# Pads the value with spaces on the left to the given width
+function(pad_left output value width)
+    string(LENGTH "${value}" length)
+    math(EXPR padding "${width} - ${length}")
+
+    if(padding GREATER 0)
+        string(REPEAT " " ${padding} spaces)
+        set(value "${spaces}${value}")
+    endif()
+
+    set(${output} "${value}" PARENT_SCOPE)
+endfunction()
+
+# Pads the value with spaces on the right to the given width
+function(pad_right output value width)
+    string(LENGTH "${value}" length)
+    math(EXPR padding "${width} - ${length}")
+
+    if(padding GREATER 0)
+        string(REPEAT " " ${padding} spaces)
+        set(value "${value}${spaces}")
+    endif()
+
+    set(${output} "${value}" PARENT_SCOPE)
+endfunction()
+
+file(STRINGS "${MAP_FILE}" lines)
+
+set(modules "")
+set(is_memory_map FALSE)
+set(section "")
+
+foreach(line IN LISTS lines)
+    # The discarded input sections are listed before the memory map, and are skipped
+    if(line MATCHES "^Linker script and memory map")
+        set(is_memory_map TRUE)
+        continue()
+    endif()
+
+    if(NOT is_memory_map)
+        continue()
+    endif()
+
+    # A long input section name is on a line of its own, followed by its address, size and module
+    if(line MATCHES "^ ([.*A-Za-z_][^ ]*)$")
+        set(section "${CMAKE_MATCH_1}")
+        continue()
+    endif()
+
+    if(line MATCHES "^ ([.*A-Za-z_][^ ]*)? +0x([0-9a-f]+) +0x([0-9a-f]+) *(.*)$")
+        if(NOT "${CMAKE_MATCH_1}" STREQUAL "")
+            set(section "${CMAKE_MATCH_1}")
+        endif()
+
+        set(address "0x${CMAKE_MATCH_2}")
+        set(size "0x${CMAKE_MATCH_3}")
+        set(module "${CMAKE_MATCH_4}")
+
+        math(EXPR size "${size}")
+        math(EXPR region "${address} >> 24")
+
+        # Debug sections and the like are not loaded anywhere
+        if(size EQUAL 0 OR (NOT region EQUAL 8 AND NOT region EQUAL 32))
+            set(section "")
+            continue()
+        endif()
+
+        # Keep the archive name of library members, but drop the directories
+        if(module MATCHES "^(.*/)?([^/]+\\.a)\\((.+)\\)$")
+            set(module "${CMAKE_MATCH_2}(${CMAKE_MATCH_3})")
+        else()
+            get_filename_component(module "${module}" NAME)
+        endif()
+
+        if(section STREQUAL "*fill*" OR module STREQUAL "")
+            set(module "(alignment fill)")
+        endif()
+
+        string(MAKE_C_IDENTIFIER "${module}" key)
+
+        if(NOT DEFINED flash_${key})
+            list(APPEND modules "${module}")
+            set(flash_${key} 0)
+            set(ram_${key} 0)
+        endif()
+
+        # Initialized data lives in RAM, and has its initial values in flash
+        if(region EQUAL 8)
+            math(EXPR flash_${key} "${flash_${key}} + ${size}")
+        elseif(section MATCHES "^\\.(t?data|RamFunc)")
+            math(EXPR flash_${key} "${flash_${key}} + ${size}")
+            math(EXPR ram_${key} "${ram_${key}} + ${size}")
+        else()
+            math(EXPR ram_${key} "${ram_${key}} + ${size}")
+        endif()
+
+        set(section "")
+    endif()
+endforeach()
+
+# Sort by flash use; the zero padding makes the string sort numeric
+set(entries "")
+set(total_flash 0)
+set(total_ram 0)
+
+foreach(module IN LISTS modules)
+    string(MAKE_C_IDENTIFIER "${module}" key)
+    math(EXPR total_flash "${total_flash} + ${flash_${key}}")
+    math(EXPR total_ram "${total_ram} + ${ram_${key}}")
+
+    string(LENGTH "${flash_${key}}" length)
+    math(EXPR padding "8 - ${length}")
+    string(REPEAT "0" ${padding} zeros)
+    list(APPEND entries "${zeros}${flash_${key}}|${module}")
+endforeach()
+
+list(SORT entries ORDER DESCENDING)
+
+pad_right(header "Module" 48)
+message("${header}     Flash       RAM")
+
+foreach(entry IN LISTS entries)
+    string(REGEX REPLACE "^[0-9]+\\|" "" module "${entry}")
+    string(MAKE_C_IDENTIFIER "${module}" key)
+
+    pad_right(name "${module}" 48)
+    pad_left(flash "${flash_${key}}" 10)
+    pad_left(ram "${ram_${key}}" 10)
+    message("${name}${flash}${ram}")
+endforeach()
+
+pad_right(name "Total" 48)
+pad_left(flash "${total_flash}" 10)
+pad_left(ram "${total_ram}" 10)
+message("${name}${flash}${ram}")
+message("The RAM total excludes the stack; see the memory usage report of the device for its high-water mark")
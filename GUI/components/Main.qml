@@ -69,18 +69,44 @@ Window {
 
                 Layout.fillWidth: true
 
+                onFrequencyMoved: frequency => {
+                    rdsPanel.resetDisplay();
+
+                    DeviceManager.tune(Math.round(frequency * 100));
+                }
+
                 Connections {
                     target: DeviceManager
 
                     function onRadioStateReportReceived(report) {
                         tunerDial.currentFrequency = report.currentFrequency / 100;
                     }
+
+                    function onSeekProgressReportReceived(report) {
+                        tunerDial.currentFrequency = report.frequency / 100;
+                    }
                 }
             }
 
             RowLayout {
+                id: seekControls
+
+                // Set while a seek is in progress; either seek button then cancels it
+                property bool isSeeking: false
+
                 Layout.alignment: Qt.AlignHCenter
 
+                Connections {
+                    target: DeviceManager
+
+                    function onRadioStateReportReceived(report) {
+                        // RADIOSTATE_TUNE_IN_PROGRESS
+                        if (report.currentState !== 2) {
+                            seekControls.isSeeking = false;
+                        }
+                    }
+                }
+
                 ModernButton {
                     enabled: DeviceManager.selectedDeviceIndex >= 0
 
@@ -92,10 +118,20 @@ Window {
                     icon.color: hovered ? '#afd8f5' : '#ACD6EE'
 
                     onClicked: {
+                        if (seekControls.isSeeking) {
+                            console.log("Seek cancel issued");
+
+                            DeviceManager.cancelSeek();
+
+                            return;
+                        }
+
                         console.log("Seek down issued");
 
                         rdsPanel.resetDisplay();
 
+                        seekControls.isSeeking = true;
+
                         DeviceManager.beginSeek(false);
                     }
                 }
@@ -109,6 +145,10 @@ Window {
                         function onRadioStateReportReceived(report) {
                             digitalDisplay.currentFrequency = report.currentFrequency / 100;
                         }
+
+                        function onSeekProgressReportReceived(report) {
+                            digitalDisplay.currentFrequency = report.frequency / 100;
+                        }
                     }
                 }
 
@@ -123,10 +163,20 @@ Window {
                     icon.color: hovered ? '#afd8f5' : '#ACD6EE'
 
                     onClicked: {
+                        if (seekControls.isSeeking) {
+                            console.log("Seek cancel issued");
+
+                            DeviceManager.cancelSeek();
+
+                            return;
+                        }
+
                         console.log("Seek up issued");
 
                         rdsPanel.resetDisplay();
 
+                        seekControls.isSeeking = true;
+
                         DeviceManager.beginSeek(true);
                     }
                 }
@@ -174,6 +224,11 @@ Window {
                             signalIndicators.receivedSignalStrength = report.rssi;
                             signalIndicators.signalToNoiseRatio = report.snr;
                         }
+
+                        function onTuneStatusReportReceived(report) {
+                            signalIndicators.receivedSignalStrength = report.rssi;
+                            signalIndicators.signalToNoiseRatio = report.snr;
+                        }
                     }
                 }
 
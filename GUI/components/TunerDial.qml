@@ -12,6 +12,9 @@ Item {
 
     property real currentFrequency
 
+    // Emitted while the user drags the dial, with the frequency in MHz
+    signal frequencyMoved(real frequency)
+
     readonly property real minFreq: 87.5
     readonly property real maxFreq: 108.0
 
@@ -39,7 +42,10 @@ Item {
 
     onCurrentFrequencyChanged: {
         console.info("Current frequency updated from the outside: " + root.currentFrequency);
-        frequencySlider.value = root.currentFrequency;
+        // The dial follows the user while it is being dragged
+        if (!frequencySlider.pressed) {
+            frequencySlider.value = root.currentFrequency;
+        }
     }
 
     Text {
@@ -116,12 +122,16 @@ Item {
                 to: root.maxFreq
 
                 stepSize: 0.1
-                live: false
+                live: true
 
                 onValueChanged: {
                     console.info("Frequency slider was dragged to: " + frequencySlider.value);
                 }
 
+                onMoved: {
+                    root.frequencyMoved(frequencySlider.value);
+                }
+
                 background: Rectangle {
                     x: frequencySlider.leftPadding
                     y: frequencySlider.topPadding
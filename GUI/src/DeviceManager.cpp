@@ -7,10 +7,16 @@ DeviceManager *DeviceManager::s_instance = nullptr;
 
 DeviceManager::DeviceManager(QObject *parent)
     : QObject(parent), m_deviceWorker(nullptr), m_reportWorker(nullptr), m_currentDevice(nullptr),
-      m_selectedDeviceIndex(-1)
+      m_selectedDeviceIndex(-1), m_tuneTimer(new QTimer(this)), m_pendingTuneFrequency(-1),
+      m_propertyBulkSequence(0), m_passthroughCorrelationId(0)
 {
     s_instance = this;
 
+    m_tuneTimer->setSingleShot(true);
+    m_tuneTimer->setInterval(TUNE_REQUEST_INTERVAL);
+
+    connect(m_tuneTimer, &QTimer::timeout, this, &DeviceManager::onTuneTimerTimeout);
+
     m_deviceWorker = new DeviceWorker();
 
     connect(m_deviceWorker, &DeviceWorker::devicesChanged, this, &DeviceManager::onDevicesChanged);
@@ -204,6 +210,99 @@ void DeviceManager::onSelectedDeviceIndexChanged(int newIndex)
                     this,
                     &DeviceManager::rdsRadioTextReportReceived);
 
+            connect(m_reportWorker,
+                    &ReportWorker::audioStatisticsReportReceived,
+                    this,
+                    &DeviceManager::audioStatisticsReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::audioLevelReportReceived,
+                    this,
+                    &DeviceManager::audioLevelReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::bootMilestonesReportReceived,
+                    this,
+                    &DeviceManager::bootMilestonesReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::presetListReportReceived,
+                    this,
+                    &DeviceManager::presetListReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::scanResultsReportReceived,
+                    this,
+                    &DeviceManager::scanResultsReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::scanSummaryReportReceived,
+                    this,
+                    &DeviceManager::scanSummaryReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::seekProgressReportReceived,
+                    this,
+                    &DeviceManager::seekProgressReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::tuneStatusReportReceived,
+                    this,
+                    &DeviceManager::tuneStatusReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::alternativeFrequencyReportReceived,
+                    this,
+                    &DeviceManager::alternativeFrequencyReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::propertyBulkReportReceived,
+                    this,
+                    &DeviceManager::propertyBulkReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::antennaCapacitorBenchmarkReportReceived,
+                    this,
+                    &DeviceManager::antennaCapacitorBenchmarkReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::interruptStatisticsReportReceived,
+                    this,
+                    &DeviceManager::interruptStatisticsReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::telemetryReportReceived,
+                    this,
+                    &DeviceManager::telemetryReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::memoryUsageReportReceived,
+                    this,
+                    &DeviceManager::memoryUsageReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::faultReportReceived,
+                    this,
+                    &DeviceManager::faultReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::subsystemRestartReportReceived,
+                    this,
+                    &DeviceManager::subsystemRestartReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::passthroughResponseReportReceived,
+                    this,
+                    &DeviceManager::passthroughResponseReportReceived);
+
+            connect(m_reportWorker,
+                    &ReportWorker::macroCompletionReportReceived,
+                    this,
+                    &DeviceManager::macroCompletionReportReceived);
+
+            // Fetch the presets stored on the device
+            requestPresets();
+
             qDebug() << "[DeviceManager] Starting the report worker";
 
             QThreadPool::globalInstance()->start(m_reportWorker);
@@ -220,27 +319,330 @@ void DeviceManager::onSelectedDeviceIndexChanged(int newIndex)
     }
 }
 
+void DeviceManager::tune(int frequency)
+{
+    if (m_tuneTimer->isActive())
+    {
+        // A tune was sent recently; only the latest frequency is sent once the radio is ready
+        m_pendingTuneFrequency = frequency;
+
+        return;
+    }
+
+    sendTuneRequest(frequency);
+}
+
+void DeviceManager::onTuneTimerTimeout()
+{
+    if (m_pendingTuneFrequency >= 0)
+    {
+        int frequency = m_pendingTuneFrequency;
+
+        m_pendingTuneFrequency = -1;
+
+        sendTuneRequest(frequency);
+    }
+}
+
+void DeviceManager::sendTuneRequest(int frequency)
+{
+    TuneFreqRequest_t request = {0};
+
+    request.frequency = (uint16_t)qBound(0, frequency, UINT16_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_TUNE_FREQ, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send tune request.";
+    }
+
+    m_tuneTimer->start();
+}
+
 void DeviceManager::beginSeek(bool seekUp)
 {
-    if (m_currentDevice)
+    SeekStartRequest_t request = {0};
+
+    request.wrap = false; // Not supported yet
+    request.seekUp = seekUp;
+
+    if (!sendRequest(REPORT_IDENTIFIER_SEEK_START, &request, sizeof(request)))
     {
-        uint8_t buf[MAX_REPORT_SIZE] = {0};
+        qDebug() << "[DeviceManager]: Could not send seek command.";
+    }
+}
 
-        buf[0] = 0x00; // Report ID; not used currently
-        buf[1] = REPORT_IDENTIFIER_SEEK_START;
-        buf[2] = 0x00; // Wrap; not supported yet
-        buf[3] = seekUp ? 0x01 : 0x00;
+void DeviceManager::setAudioLevelWindow(int window)
+{
+    AudioLevelWindowRequest_t request = {0};
 
-        int res = hid_write(m_currentDevice, buf, sizeof(buf));
-        if (res < 0)
+    request.window = (uint16_t)qBound(0, window, UINT16_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_SET_AUDIO_LEVEL_WINDOW, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send audio level window request.";
+    }
+}
+
+void DeviceManager::storePreset(int index, int frequency)
+{
+    PresetStoreRequest_t request = {0};
+
+    request.index = (uint8_t)index;
+    request.frequency = (uint16_t)qBound(0, frequency, UINT16_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_PRESET_STORE, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send preset store request.";
+    }
+}
+
+void DeviceManager::recallPreset(int index)
+{
+    PresetRecallRequest_t request = {0};
+
+    request.index = (uint8_t)index;
+
+    if (!sendRequest(REPORT_IDENTIFIER_PRESET_RECALL, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send preset recall request.";
+    }
+}
+
+void DeviceManager::requestPresets()
+{
+    if (!sendRequest(REPORT_IDENTIFIER_PRESET_LIST_REQUEST, nullptr, 0))
+    {
+        qDebug() << "[DeviceManager]: Could not send preset list request.";
+    }
+}
+
+void DeviceManager::startScan()
+{
+    if (!sendRequest(REPORT_IDENTIFIER_SCAN_START, nullptr, 0))
+    {
+        qDebug() << "[DeviceManager]: Could not send scan start request.";
+    }
+}
+
+void DeviceManager::stopScan()
+{
+    if (!sendRequest(REPORT_IDENTIFIER_SCAN_STOP, nullptr, 0))
+    {
+        qDebug() << "[DeviceManager]: Could not send scan stop request.";
+    }
+}
+
+void DeviceManager::cancelSeek()
+{
+    if (!sendRequest(REPORT_IDENTIFIER_SEEK_CANCEL, nullptr, 0))
+    {
+        qDebug() << "[DeviceManager]: Could not send seek cancel request.";
+    }
+}
+
+void DeviceManager::startAntennaCapacitorBenchmark()
+{
+    if (!sendRequest(REPORT_IDENTIFIER_ANTCAP_BENCHMARK_START, nullptr, 0))
+    {
+        qDebug() << "[DeviceManager]: Could not send antenna capacitor benchmark request.";
+    }
+}
+
+void DeviceManager::overrideAGC(bool isAGCDisabled, int lnaGainIndex)
+{
+    AGCOverrideRequest_t request = {0};
+
+    request.isAGCDisabled = isAGCDisabled;
+    request.lnaGainIndex = (uint8_t)qBound(0, lnaGainIndex, 26);
+
+    if (!sendRequest(REPORT_IDENTIFIER_AGC_OVERRIDE, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send AGC override request.";
+    }
+}
+
+void DeviceManager::setProperties(const QVariantList &properties)
+{
+    sendPropertyBulkRequests(REPORT_IDENTIFIER_PROPERTY_SET_BULK, properties);
+}
+
+void DeviceManager::getProperties(const QVariantList &properties)
+{
+    sendPropertyBulkRequests(REPORT_IDENTIFIER_PROPERTY_GET_BULK, properties);
+}
+
+void DeviceManager::configureAlternativeFrequencies(bool isEnabled, int rssiThreshold, int snrThreshold,
+                                                    int minimumGain)
+{
+    AlternativeFrequencyConfigRequest_t request = {0};
+
+    request.isEnabled = isEnabled;
+    request.rssiThreshold = (uint8_t)qBound(0, rssiThreshold, UINT8_MAX);
+    request.snrThreshold = (uint8_t)qBound(0, snrThreshold, UINT8_MAX);
+    request.minimumGain = (uint8_t)qBound(0, minimumGain, UINT8_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_AF_CONFIG, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send alternative frequency configuration.";
+    }
+}
+
+void DeviceManager::requestTelemetry(int interval)
+{
+    TelemetryRequest_t request = {0};
+
+    request.interval = (uint16_t)qBound(0, interval, UINT16_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_TELEMETRY_REQUEST, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send telemetry request.";
+    }
+}
+
+void DeviceManager::setRadioStatusHeartbeat(int interval)
+{
+    RadioStatusHeartbeatRequest_t request = {0};
+
+    request.interval = (uint16_t)qBound(0, interval, UINT16_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_RADIO_STATUS_HEARTBEAT, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send radio status heartbeat.";
+    }
+}
+
+int DeviceManager::passThroughCommand(int opCode, const QVariantList &args, int responseLength)
+{
+    PassthroughRequest_t request = {0};
+
+    // Zero is reserved for the commands of the firmware
+    if (++m_passthroughCorrelationId == 0)
+    {
+        m_passthroughCorrelationId = 1;
+    }
+
+    request.correlationId = m_passthroughCorrelationId;
+    request.opCode = (uint8_t)qBound(0, opCode, UINT8_MAX);
+    request.argLength = (uint8_t)qMin<qsizetype>(sizeof(request.args), args.size());
+    request.responseLength = (uint8_t)qBound(0, responseLength, 16);
+
+    for (uint8_t i = 0; i < request.argLength; i++)
+    {
+        request.args[i] = (uint8_t)args[i].toUInt();
+    }
+
+    if (!sendRequest(REPORT_IDENTIFIER_PASSTHROUGH, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not send passthrough command" << request.correlationId;
+
+        return 0;
+    }
+
+    // The response report carries the same identifier
+    return request.correlationId;
+}
+
+void DeviceManager::storeMacro(int macroId, const QVariantList &commands)
+{
+    MacroStoreRequest_t request = {0};
+
+    request.macroId = (uint8_t)qBound(0, macroId, MACRO_SLOT_COUNT - 1);
+    request.count = (uint8_t)qMin<qsizetype>(MACRO_RECORD_COUNT, commands.size());
+
+    // Each command is an { opCode, args } map, with the arguments following the opcode
+    for (uint8_t i = 0; i < request.count; i++)
+    {
+        QVariantMap map = commands[i].toMap();
+        QVariantList args = map.value("args").toList();
+
+        request.records[i].opCode = (uint8_t)map.value("opCode").toUInt();
+        request.records[i].argLength = (uint8_t)qMin<qsizetype>(sizeof(request.records[i].args), args.size());
+
+        for (uint8_t j = 0; j < request.records[i].argLength; j++)
+        {
+            request.records[i].args[j] = (uint8_t)args[j].toUInt();
+        }
+    }
+
+    if (!sendRequest(REPORT_IDENTIFIER_MACRO_STORE, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not store macro" << request.macroId;
+    }
+}
+
+void DeviceManager::runMacro(int macroId)
+{
+    MacroRunRequest_t request = {0};
+
+    request.macroId = (uint8_t)qBound(0, macroId, UINT8_MAX);
+
+    if (!sendRequest(REPORT_IDENTIFIER_MACRO_RUN, &request, sizeof(request)))
+    {
+        qDebug() << "[DeviceManager]: Could not run macro" << request.macroId;
+    }
+}
+
+void DeviceManager::sendPropertyBulkRequests(ReportIdentifier_t identifier, const QVariantList &properties)
+{
+    // Each entry is either a { property, value } map, or just the property identifier for a get
+    for (qsizetype first = 0; first < properties.size(); first += PROPERTY_BULK_COUNT)
+    {
+        PropertyBulkRequest_t request = {0};
+
+        request.sequence = m_propertyBulkSequence++;
+        request.count = (uint8_t)qMin<qsizetype>(PROPERTY_BULK_COUNT, properties.size() - first);
+
+        for (uint8_t i = 0; i < request.count; i++)
         {
-            QString error = QString::fromWCharArray(hid_error(m_currentDevice));
+            const QVariant &entry = properties[first + i];
+
+            if (entry.canConvert<QVariantMap>())
+            {
+                QVariantMap map = entry.toMap();
 
-            qDebug() << "[DeviceManager]: Error during HID write" << error;
+                request.properties[i].property = (uint16_t)map.value("property").toUInt();
+                request.properties[i].value = (uint16_t)map.value("value").toUInt();
+            }
+            else
+            {
+                request.properties[i].property = (uint16_t)entry.toUInt();
+            }
+        }
+
+        if (!sendRequest(identifier, &request, sizeof(request)))
+        {
+            qDebug() << "[DeviceManager]: Could not send bulk property request" << request.sequence;
         }
     }
-    else
+}
+
+bool DeviceManager::sendRequest(ReportIdentifier_t identifier, const void *request, size_t size)
+{
+    if (!m_currentDevice)
+    {
+        qDebug() << "[DeviceManager]: No device is currently selected; cannot send request.";
+
+        return false;
+    }
+
+    uint8_t buf[MAX_REPORT_SIZE] = {0};
+
+    buf[0] = 0x00; // Report ID; not used currently
+    buf[1] = identifier;
+    if (request)
     {
-        qDebug() << "[DeviceManager]: No device is currently selected; cannot send seek command.";
+        std::memcpy(&buf[2], request, qMin(size, sizeof(buf) - 2));
     }
+
+    int res = hid_write(m_currentDevice, buf, sizeof(buf));
+    if (res < 0)
+    {
+        QString error = QString::fromWCharArray(hid_error(m_currentDevice));
+
+        qDebug() << "[DeviceManager]: Error during HID write" << error;
+
+        return false;
+    }
+
+    return true;
 }
@@ -10,6 +10,10 @@
 #include <QVariantList>
 #include <QtQml/qqmlregistration.h>
 
+// Time the radio takes to tune to a new frequency, in ms; tune requests are
+// not sent faster than this
+#define TUNE_REQUEST_INTERVAL 60
+
 class DeviceManager : public QObject
 {
     Q_OBJECT
@@ -38,14 +42,56 @@ class DeviceManager : public QObject
     void rsqStatusReportReceived(RSQStatusResponse_t report);
     void rdsProgrammeServiceReportReceived(RDSProgrammeServiceReport_t report);
     void rdsRadioTextReportReceived(RDSRadioTextReport_t report);
+    void audioStatisticsReportReceived(AudioStatisticsReport_t report);
+    void audioLevelReportReceived(AudioLevelReport_t report);
+    void bootMilestonesReportReceived(BootMilestonesReport_t report);
+    void presetListReportReceived(PresetListReport_t report);
+    void scanResultsReportReceived(ScanResultsReport_t report);
+    void scanSummaryReportReceived(ScanSummaryReport_t report);
+    void seekProgressReportReceived(SeekProgressReport_t report);
+    void tuneStatusReportReceived(TuneStatusReport_t report);
+    void alternativeFrequencyReportReceived(AlternativeFrequencyReport_t report);
+    void propertyBulkReportReceived(PropertyBulkReport_t report);
+    void antennaCapacitorBenchmarkReportReceived(AntennaCapacitorBenchmarkReport_t report);
+    void interruptStatisticsReportReceived(InterruptStatisticsReport_t report);
+    void telemetryReportReceived(TelemetryReport_t report);
+    void memoryUsageReportReceived(MemoryUsageReport_t report);
+    void faultReportReceived(FaultReport_t report);
+    void subsystemRestartReportReceived(SubsystemRestartReport_t report);
+    void passthroughResponseReportReceived(PassthroughResponseReport_t report);
+    void macroCompletionReportReceived(MacroCompletionReport_t report);
 
   public slots:
     void onDevicesChanged(QList<Device> newDevices);
     void onDisconnectCurrentDevice();
+    void tune(int frequency);
     void beginSeek(bool seekUp);
+    void setAudioLevelWindow(int window);
+    void storePreset(int index, int frequency = 0);
+    void recallPreset(int index);
+    void requestPresets();
+    void startScan();
+    void stopScan();
+    void cancelSeek();
+    void startAntennaCapacitorBenchmark();
+    void overrideAGC(bool isAGCDisabled, int lnaGainIndex);
+    void setProperties(const QVariantList &properties);
+    void getProperties(const QVariantList &properties);
+    void configureAlternativeFrequencies(bool isEnabled, int rssiThreshold, int snrThreshold, int minimumGain);
+    void requestTelemetry(int interval = 0);
+    void setRadioStatusHeartbeat(int interval);
+    int passThroughCommand(int opCode, const QVariantList &args, int responseLength = 0);
+    void storeMacro(int macroId, const QVariantList &commands);
+    void runMacro(int macroId);
 
   private slots:
     void onSelectedDeviceIndexChanged(int newIndex);
+    void onTuneTimerTimeout();
+
+  private:
+    bool sendRequest(ReportIdentifier_t identifier, const void *request, size_t size);
+    void sendTuneRequest(int frequency);
+    void sendPropertyBulkRequests(ReportIdentifier_t identifier, const QVariantList &properties);
 
   private:
     int m_selectedDeviceIndex;
@@ -53,6 +99,10 @@ class DeviceManager : public QObject
     DeviceWorker *m_deviceWorker;
     ReportWorker *m_reportWorker;
     hid_device *m_currentDevice;
+    QTimer *m_tuneTimer;
+    int m_pendingTuneFrequency;
+    uint8_t m_propertyBulkSequence;
+    uint8_t m_passthroughCorrelationId;
     static DeviceManager *s_instance;
 };
 
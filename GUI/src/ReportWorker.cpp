@@ -7,6 +7,7 @@ ReportWorker::ReportWorker(hid_device *selectedDevice)
       m_stopped(false)
 {
     m_signalQualityLog.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    m_hostClock.start();
 }
 
 ReportWorker::~ReportWorker()
@@ -27,6 +28,9 @@ void ReportWorker::run()
     uint8_t errorCount = 0;
     double frequency = 0.0;
 
+    // The current state is read first, so that the views do not wait for the periodic reports to fill in
+    QList<QByteArray> snapshots = readSnapshots();
+
     while (!m_shouldStop)
     {
         if (errorCount >= 5)
@@ -38,7 +42,21 @@ void ReportWorker::run()
 
         uint8_t buf[MAX_REPORT_SIZE];
 
-        int res = hid_read_timeout(m_selectedDevice, buf, sizeof(buf), 250);
+        const bool isSnapshot = !snapshots.isEmpty();
+        int res;
+
+        if (isSnapshot)
+        {
+            const QByteArray snapshot = snapshots.takeFirst();
+
+            std::memcpy(buf, snapshot.constData(), snapshot.size());
+            res = snapshot.size();
+        }
+        else
+        {
+            res = hid_read_timeout(m_selectedDevice, buf, sizeof(buf), 250);
+        }
+
         if (res > 0)
         {
             errorCount = 0;
@@ -46,6 +64,9 @@ void ReportWorker::run()
             // buf[0] contains the identifier of the report
             ReportIdentifier_t identifier = (ReportIdentifier_t)buf[0];
 
+            // Time at which the device generated the report, on the host clock, in µs
+            const qint64 generatedAt = timeReport(buf, isSnapshot);
+
             switch (identifier)
             {
             case REPORT_IDENTIFIER_RADIO_STATUS: {
@@ -73,8 +94,9 @@ void ReportWorker::run()
 
                 if (m_signalQualityLog.isOpen() && frequency > 0.0)
                 {
-                    QString logEntry = QString("%1 MHz\tRSSI: %2 dBuV\tNoise ratio: %3 dB\tStereo pilot detected: "
-                                               "%4\tStereo blend: %5 %\tMultipath: %6\n")
+                    QString logEntry = QString("%1 s\t%2 MHz\tRSSI: %3 dBuV\tNoise ratio: %4 dB\tStereo pilot detected: "
+                                               "%5\tStereo blend: %6 %\tMultipath: %7\n")
+                                           .arg(generatedAt / 1e6, 0, 'f', 6)
                                            .arg(frequency, 0, 'f', 1)
                                            .arg(report.rssi)
                                            .arg(report.snr)
@@ -105,6 +127,202 @@ void ReportWorker::run()
 
                 break;
             }
+            case REPORT_IDENTIFIER_AUDIO_STATISTICS: {
+                AudioStatisticsReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(AudioStatisticsReport_t));
+
+                emit audioStatisticsReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_AUDIO_LEVELS: {
+                AudioLevelReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(AudioLevelReport_t));
+
+                emit audioLevelReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_BOOT_MILESTONES: {
+                BootMilestonesReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(BootMilestonesReport_t));
+
+                qDebug() << "[ReportWorker] Boot milestones (ms): enumerated" << report.enumerated
+                         << "oscillator ready" << report.oscillatorReady << "radio ready" << report.radioReady
+                         << "first audio" << report.firstAudio;
+
+                emit bootMilestonesReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_PRESET_LIST: {
+                PresetListReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(PresetListReport_t));
+
+                emit presetListReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_SCAN_RESULTS: {
+                ScanResultsReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(ScanResultsReport_t));
+
+                emit scanResultsReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_SCAN_SUMMARY: {
+                ScanSummaryReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(ScanSummaryReport_t));
+
+                qDebug() << "[ReportWorker] Scan finished:" << report.channelCount << "channels," << report.validCount
+                         << "valid, in" << report.duration << "ms";
+
+                emit scanSummaryReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_SEEK_PROGRESS: {
+                SeekProgressReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(SeekProgressReport_t));
+
+                emit seekProgressReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_TUNE_STATUS: {
+                TuneStatusReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(TuneStatusReport_t));
+
+                emit tuneStatusReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_AF_STATUS: {
+                AlternativeFrequencyReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(AlternativeFrequencyReport_t));
+
+                qDebug() << "[ReportWorker] Alternative frequencies:" << report.count << "for PI"
+                         << Qt::hex << report.programmeIdentification << Qt::dec << "," << report.switchCount
+                         << "switches in" << report.checkCount << "checks, muted for" << report.muteTime << "ms";
+
+                emit alternativeFrequencyReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_PROPERTY_BULK_RESULT: {
+                PropertyBulkReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(PropertyBulkReport_t));
+
+                if (report.failedCount > 0)
+                {
+                    qDebug() << "[ReportWorker] Bulk property request" << report.sequence << ":" << report.failedCount
+                             << "of" << report.count << "properties failed";
+                }
+
+                emit propertyBulkReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_ANTCAP_BENCHMARK: {
+                AntennaCapacitorBenchmarkReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(AntennaCapacitorBenchmarkReport_t));
+
+                qDebug() << "[ReportWorker] Tune times over" << report.presetCount << "presets (us): automatic average"
+                         << report.automaticAverage << "max" << report.automaticMaximum << ", cached average"
+                         << report.cachedAverage << "max" << report.cachedMaximum;
+
+                emit antennaCapacitorBenchmarkReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_INTERRUPT_STATISTICS: {
+                InterruptStatisticsReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(InterruptStatisticsReport_t));
+
+                if (report.spuriousWakeups > 0)
+                {
+                    qDebug() << "[ReportWorker]" << report.spuriousWakeups << "of" << report.wakeups
+                             << "radio interrupts raised no new source";
+                }
+
+                emit interruptStatisticsReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_TELEMETRY: {
+                TelemetryReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(TelemetryReport_t));
+
+                if (report.droppedCommands > 0 || report.droppedReports > 0)
+                {
+                    qDebug() << "[ReportWorker] Dropped" << report.droppedCommands << "commands and"
+                             << report.droppedReports << "reports so far";
+                }
+
+                emit telemetryReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_MEMORY_USAGE: {
+                MemoryUsageReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(MemoryUsageReport_t));
+
+                if (report.stackHighWater > report.stackReserve)
+                {
+                    qDebug() << "[ReportWorker] Stack high-water mark" << report.stackHighWater
+                             << "bytes exceeds the reserve of" << report.stackReserve << "bytes";
+                }
+
+                emit memoryUsageReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_FAULT: {
+                FaultReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(FaultReport_t));
+
+                qDebug() << "[ReportWorker] Device recovered from fault source" << int(report.source) << "at PC"
+                         << Qt::hex << report.programCounter << "LR" << report.linkRegister << "with command"
+                         << int(report.commandOpCode) << Qt::dec << "at the front of the queue;" << report.faultCount
+                         << "faults since power-on";
+
+                emit faultReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_SUBSYSTEM_RESTART: {
+                SubsystemRestartReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(SubsystemRestartReport_t));
+
+                qDebug() << "[ReportWorker] Device restarted subsystem" << int(report.subsystem) << "with command"
+                         << Qt::hex << int(report.commandOpCode) << Qt::dec << "at the front of the queue;"
+                         << report.restartCount << "restarts since reset";
+
+                emit subsystemRestartReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_PASSTHROUGH_RESPONSE: {
+                PassthroughResponseReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(PassthroughResponseReport_t));
+
+                emit passthroughResponseReportReceived(report);
+
+                break;
+            }
+            case REPORT_IDENTIFIER_MACRO_COMPLETION: {
+                MacroCompletionReport_t report;
+                std::memcpy(&report, &buf[1], sizeof(MacroCompletionReport_t));
+
+                qDebug() << "[ReportWorker] Macro" << report.macroId << "ended with result" << int(report.result)
+                         << "after" << report.completedCount << "of" << report.commandCount << "commands in"
+                         << report.duration << "µs";
+
+                emit macroCompletionReportReceived(report);
+
+                break;
+            }
             }
         }
         else if (res < 0)
@@ -128,3 +346,141 @@ void ReportWorker::run()
 
     m_stopped = true;
 }
+
+QList<QByteArray> ReportWorker::readSnapshots()
+{
+    const ReportIdentifier_t identifiers[] = {
+        REPORT_IDENTIFIER_RADIO_STATUS,   REPORT_IDENTIFIER_RSQ_STATUS, REPORT_IDENTIFIER_RDS_PROGRAMME_SERVICE,
+        REPORT_IDENTIFIER_RDS_RADIO_TEXT, REPORT_IDENTIFIER_TELEMETRY,
+    };
+
+    QList<QByteArray> snapshots;
+
+    for (const ReportIdentifier_t identifier : identifiers)
+    {
+        // The descriptor declares no report identifiers, so the feature report is report zero, and the first byte
+        // of the buffer stays zero both ways; the snapshot is selected first, on the same control pipe as the read
+        uint8_t buf[MAX_REPORT_SIZE + 1] = {0};
+
+        buf[1] = REPORT_IDENTIFIER_SNAPSHOT_SELECT;
+        buf[2] = identifier;
+
+        int res = hid_send_feature_report(m_selectedDevice, buf, sizeof(buf));
+        if (res >= 0)
+        {
+            std::memset(buf, 0, sizeof(buf));
+
+            res = hid_get_feature_report(m_selectedDevice, buf, sizeof(buf));
+        }
+
+        // The snapshot is laid out like an input report: the identifier, then the struct bytes
+        if (res > 1 + REPORT_ENVELOPE_OFFSET + REPORT_ENVELOPE_SIZE && buf[1] == identifier)
+        {
+            snapshots.append(QByteArray((const char *)&buf[1], res - 1));
+        }
+        else if (res < 0)
+        {
+            // The device stalls the request when it has no state to give yet, or when its firmware has no snapshots;
+            // the periodic reports fill in the state instead
+            qDebug() << "[ReportWorker] No snapshot of report" << identifier << ":"
+                     << QString::fromWCharArray(hid_error(m_selectedDevice));
+        }
+    }
+
+    return snapshots;
+}
+
+qint64 ReportWorker::timeReport(const uint8_t *buf, bool isSnapshot)
+{
+    // The window over which the fastest delivery is looked for; long enough to catch one, short enough to follow drift
+    constexpr qint64 offsetWindow = 10'000'000;
+
+    // How often the latency histogram is logged, in reports
+    constexpr quint32 histogramInterval = 1000;
+
+    const qint64 arrival = m_hostClock.nsecsElapsed() / 1000;
+
+    ReportEnvelope_t envelope;
+    std::memcpy(&envelope, &buf[1 + REPORT_ENVELOPE_OFFSET], REPORT_ENVELOPE_SIZE);
+
+    if (m_hasEnvelope && envelope.timestamp < m_lastTimestamp)
+    {
+        if (m_lastTimestamp - envelope.timestamp > 0x80000000u)
+        {
+            m_deviceTimeBase += 0x100000000ll;
+        }
+        else
+        {
+            // The device clock went back, so the device has been reset; start the correlation over
+            qDebug() << "[ReportWorker] Device clock went back; restarting the time correlation";
+
+            m_hasEnvelope = false;
+            m_hasSequence = false;
+            m_deviceTimeBase = 0;
+        }
+    }
+
+    const qint64 deviceTime = m_deviceTimeBase + envelope.timestamp;
+    const qint64 offset = arrival - deviceTime;
+
+    // A snapshot carries the sequence number of the next queued report without using it up, so only the queued
+    // reports are checked for gaps
+    if (!isSnapshot)
+    {
+        const uint8_t missing = (uint8_t)(envelope.sequence - m_lastSequence - 1);
+
+        if (m_hasSequence && missing > 0)
+        {
+            m_droppedReports += missing;
+
+            qDebug() << "[ReportWorker]" << missing << "reports lost before report" << envelope.sequence << ";"
+                     << m_droppedReports << "so far";
+        }
+
+        m_hasSequence = true;
+        m_lastSequence = envelope.sequence;
+    }
+
+    if (!m_hasEnvelope)
+    {
+        m_windowStart = arrival;
+        m_windowOffset = offset;
+        m_previousWindowOffset = offset;
+    }
+    else
+    {
+        m_windowOffset = qMin(m_windowOffset, offset);
+
+        if (arrival - m_windowStart >= offsetWindow)
+        {
+            m_previousWindowOffset = m_windowOffset;
+            m_windowOffset = offset;
+            m_windowStart = arrival;
+        }
+    }
+
+    m_hasEnvelope = true;
+    m_lastTimestamp = envelope.timestamp;
+
+    const qint64 clockOffset = qMin(m_windowOffset, m_previousWindowOffset);
+    const qint64 latency = offset - clockOffset;
+
+    // Bucket 0 is below 1 ms, and each following bucket doubles the limit
+    size_t bucket = 0;
+
+    while (bucket < m_latencyHistogram.size() - 1 && latency >= (1000ll << bucket))
+    {
+        bucket++;
+    }
+
+    m_latencyHistogram[bucket]++;
+
+    if (++m_timedReports % histogramInterval == 0)
+    {
+        qDebug() << "[ReportWorker] Report latency above the fastest delivery (<1, <2, <4, <8, <16, <32, <64, >=64 ms):"
+                 << m_latencyHistogram[0] << m_latencyHistogram[1] << m_latencyHistogram[2] << m_latencyHistogram[3]
+                 << m_latencyHistogram[4] << m_latencyHistogram[5] << m_latencyHistogram[6] << m_latencyHistogram[7];
+    }
+
+    return deviceTime + clockOffset;
+}
@@ -2,12 +2,16 @@
 #define __REPORTWORKER_H__
 
 #include "Device.h"
+#include <QElapsedTimer>
 #include <QEventLoop>
+#include <QByteArray>
 #include <QFile>
+#include <QList>
 #include <QObject>
 #include <QRunnable>
 #include <QTimer>
 #include <Reports.h>
+#include <array>
 
 class ReportWorker : public QObject, public QRunnable
 {
@@ -27,12 +31,32 @@ class ReportWorker : public QObject, public QRunnable
 
   private:
     void pollReports();
+    QList<QByteArray> readSnapshots();
+    qint64 timeReport(const uint8_t *buf, bool isSnapshot);
 
   signals:
     void radioStateReportReceived(RadioStatusResponse_t report);
     void rsqStatusReportReceived(RSQStatusResponse_t report);
     void rdsProgrammeServiceReportReceived(RDSProgrammeServiceReport_t report);
     void rdsRadioTextReportReceived(RDSRadioTextReport_t report);
+    void audioStatisticsReportReceived(AudioStatisticsReport_t report);
+    void audioLevelReportReceived(AudioLevelReport_t report);
+    void bootMilestonesReportReceived(BootMilestonesReport_t report);
+    void presetListReportReceived(PresetListReport_t report);
+    void scanResultsReportReceived(ScanResultsReport_t report);
+    void scanSummaryReportReceived(ScanSummaryReport_t report);
+    void seekProgressReportReceived(SeekProgressReport_t report);
+    void tuneStatusReportReceived(TuneStatusReport_t report);
+    void alternativeFrequencyReportReceived(AlternativeFrequencyReport_t report);
+    void propertyBulkReportReceived(PropertyBulkReport_t report);
+    void antennaCapacitorBenchmarkReportReceived(AntennaCapacitorBenchmarkReport_t report);
+    void interruptStatisticsReportReceived(InterruptStatisticsReport_t report);
+    void telemetryReportReceived(TelemetryReport_t report);
+    void memoryUsageReportReceived(MemoryUsageReport_t report);
+    void faultReportReceived(FaultReport_t report);
+    void subsystemRestartReportReceived(SubsystemRestartReport_t report);
+    void passthroughResponseReportReceived(PassthroughResponseReport_t report);
+    void macroCompletionReportReceived(MacroCompletionReport_t report);
     void disconnectCurrentDevice();
 
   private:
@@ -40,6 +64,28 @@ class ReportWorker : public QObject, public QRunnable
     bool m_stopped;
     hid_device *m_selectedDevice;
     QFile m_signalQualityLog;
+
+    // Host monotonic clock that the device time is correlated with
+    QElapsedTimer m_hostClock;
+
+    // Envelope of the previous report, and the device time extended past its 32-bit wrap-around, in µs; the sequence
+    // number is that of the previous queued report
+    bool m_hasEnvelope = false;
+    bool m_hasSequence = false;
+    uint8_t m_lastSequence = 0;
+    uint32_t m_lastTimestamp = 0;
+    qint64 m_deviceTimeBase = 0;
+
+    // Smallest difference of the host arrival time and the device time, in µs, over the current and the previous
+    // window; the report delivered the fastest sets the offset between the clocks
+    qint64 m_windowStart = 0;
+    qint64 m_windowOffset = 0;
+    qint64 m_previousWindowOffset = 0;
+
+    // Delivery latency above the fastest delivery, in buckets of 1, 2, 4, 8, 16, 32, 64 ms and beyond
+    std::array<quint32, 8> m_latencyHistogram = {};
+    quint32 m_timedReports = 0;
+    quint32 m_droppedReports = 0;
 };
 
 #endif // __REPORTWORKER_H__